@@ -0,0 +1,211 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: batch.cpp
+//
+//  @brief Solves many instances at once, each with its own time budget, and
+//  writes the results with the columns of roda.sh.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "metaheuristic.hpp"
+#include "search.hpp"
+#include "reduce.hpp"
+
+#include <getopt.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+const float GA_BOUND_TIME = 100; // Milliseconds of genetic algorithm before branch and bound, which it then runs alongside
+const double GRACE = 5;          // Seconds after the budget before a solver is killed
+
+////////////////////////////////////////////////////////////////////////////////
+// Prints command line usage and exits
+void usage(char *prog)
+{
+  std::cerr << "Usage: " << prog << " [options] <bnb | heur> <instance>..." << std::endl;
+  std::cerr << "  -j, --jobs N        instances solved at once (default number of cores)" << std::endl;
+  std::cerr << "  -l, --limit S       seconds for each instance (default 180 for bnb, 30 for heur)" << std::endl;
+  std::cerr << "  -m, --memory MB     memory for open nodes of each instance (default 1024)" << std::endl;
+  std::cerr << "  -o, --output F      appends the results to file F instead of stdout" << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Solves an instance on a process of its own, which asks the solver to stop
+// once the budget is over, and writes the result fields after the instance
+// name to fd. The global state of the solvers belongs to the process
+void solve(bool bnb, char* instance, double limit, size_t memory_mb, int fd)
+{
+  std::thread([limit]() {
+    std::this_thread::sleep_for(std::chrono::duration<double>(limit));
+    stop_requested = true;
+  }).detach();
+
+  read_input(instance);
+
+  std::ostringstream out;
+  if(bnb) {
+    ga_start();
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(std::min<double>(GA_BOUND_TIME, limit * 1000)));
+    explore(1, memory_mb);
+    ga_stop();
+
+    std::lock_guard<std::mutex> guard(sol_lock);
+    out << restore_solution(best_sol.sol) << ";" << best_sol.lower_bound << ";";
+    out << std::min(best_sol.lower_bound, search_dual_bound()) << ";" << search_explored_nodes();
+  } else {
+    genetic_algorithm(limit * 1000);
+
+    std::lock_guard<std::mutex> guard(sol_lock);
+    out << restore_solution(best_sol.sol) << ";" << best_sol.lower_bound;
+  }
+
+  std::string line = out.str();
+  if(write(fd, line.data(), line.size()) != (ssize_t)line.size()) _exit(EXIT_FAILURE);
+  _exit(EXIT_SUCCESS);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Instance being solved by a child process
+struct job
+{
+  size_t instance; // index in the instance list
+  pid_t pid;
+  int fd;          // read end of the pipe with the result
+  std::string result;
+  std::chrono::steady_clock::time_point start;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Main function. Solves the instances given and prints their results in order
+int main(int argc, char **argv)
+{
+  short jobs = std::max(1u, std::thread::hardware_concurrency());
+  double limit = -1;
+  size_t memory_mb = 1024;
+  const char* output = nullptr;
+
+  // Reads options
+  static struct option options[] = {
+    {"jobs", required_argument, 0, 'j'},
+    {"limit", required_argument, 0, 'l'},
+    {"memory", required_argument, 0, 'm'},
+    {"output", required_argument, 0, 'o'},
+    {0, 0, 0, 0}
+  };
+  int opt;
+  while((opt = getopt_long(argc, argv, "j:l:m:o:", options, nullptr)) != -1) {
+    switch(opt) {
+      case 'j': jobs = std::max(1, atoi(optarg)); break;
+      case 'l': limit = std::max(0.001, atof(optarg)); break;
+      case 'm': memory_mb = std::max(1, atoi(optarg)); break;
+      case 'o': output = optarg; break;
+      default: usage(argv[0]);
+    }
+  }
+  if(optind + 1 >= argc) usage(argv[0]);
+
+  std::string alg = argv[optind];
+  if(alg != "bnb" && alg != "heur") usage(argv[0]);
+  bool bnb = alg == "bnb";
+  if(limit < 0) limit = bnb ? 180 : 30;
+
+  std::vector<char*> instances(argv + optind + 1, argv + argc);
+
+  FILE* out = output ? fopen(output, "a") : stdout;
+  if(!out) {
+    std::cerr << "Cannot open " << output << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  fprintf(out, "Resultados: %s\n", alg.c_str());
+  fprintf(out, bnb ? "Instancia;Solucao;Custo;Lim. Inf.;Nos;Tempo\n" : "Instancia;Solucao;Custo;Tempo\n");
+  fflush(out);
+
+  // Results are printed in the order of the instances, as soon as the ones
+  // before them are done
+  std::vector<std::string> rows(instances.size());
+  std::vector<bool> finished(instances.size(), false);
+  size_t next = 0, printed = 0;
+  std::vector<job> running;
+
+  while(printed < instances.size()) {
+    // Starts solvers while there are free jobs
+    while(next < instances.size() && (short)running.size() < jobs) {
+      int fds[2];
+      if(pipe(fds) != 0) { perror("pipe"); exit(EXIT_FAILURE); }
+
+      fflush(out);
+      pid_t pid = fork();
+      if(pid < 0) { perror("fork"); exit(EXIT_FAILURE); }
+      if(pid == 0) {
+        close(fds[0]);
+        solve(bnb, instances[next], limit, memory_mb, fds[1]);
+      }
+
+      close(fds[1]);
+      job j;
+      j.instance = next++;
+      j.pid = pid;
+      j.fd = fds[0];
+      j.start = std::chrono::steady_clock::now();
+      running.push_back(j);
+    }
+
+    // Waits for results, or for a solver to overrun its budget
+    std::vector<pollfd> polls;
+    for(job& j: running) polls.push_back(pollfd{ j.fd, POLLIN, 0 });
+    poll(polls.data(), polls.size(), 100);
+
+    for(size_t k=0; k < running.size(); ) {
+      job& j = running[k];
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - j.start;
+
+      bool eof = false;
+      if(polls[k].revents) {
+        char buf[4096];
+        ssize_t n = read(j.fd, buf, sizeof(buf));
+        if(n > 0) j.result.append(buf, n);
+        else eof = true;
+      }
+      if(!eof && elapsed.count() > limit + GRACE) {
+        kill(j.pid, SIGKILL);
+        j.result.clear();
+        eof = true;
+      }
+      if(!eof) { k++; continue; }
+
+      int status;
+      close(j.fd);
+      waitpid(j.pid, &status, 0);
+
+      // Same fields as roda.sh, the time as given by /usr/bin/time
+      const char* name = strrchr(instances[j.instance], '/');
+      name = name ? name + 1 : instances[j.instance];
+      bool ok = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS && !j.result.empty();
+
+      char time[32];
+      snprintf(time, sizeof(time), "%.2f", elapsed.count());
+      if(ok) rows[j.instance] = std::string(name) + ";" + j.result + ";" + time;
+      else rows[j.instance] = std::string(name) + (bnb ? ";erro;erro;erro;erro;erro" : ";erro;erro;erro");
+      finished[j.instance] = true;
+
+      polls.erase(polls.begin() + k);
+      running.erase(running.begin() + k);
+    }
+
+    for(; printed < instances.size() && finished[printed]; printed++) {
+      fprintf(out, "%s\n", rows[printed].c_str());
+      fflush(out);
+    }
+  }
+
+  if(out != stdout) fclose(out);
+
+  return EXIT_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,288 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: bench.cpp
+//
+//  @brief Microbenchmarks of the solver kernels, one JSON line per instance
+//  and kernel. Also checks that the genetic algorithm does not allocate once
+//  warm.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "metaheuristic.hpp"
+#include "bound.hpp"
+#include "search.hpp"
+
+#include <getopt.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+const int INPUTS = 512;          // random inputs each kernel cycles through
+const double MIN_BATCH = 0.02;   // seconds a timed batch lasts at least
+const int WARMUP_GENERATIONS = 50; // generations before allocations are counted
+
+static int reps = 5;                       // timed batches of each kernel
+static long long unsigned max_nodes = 50000; // nodes of each explore
+static uint64_t seed = 0;
+static volatile long long sink;            // keeps results alive
+static int generations = 0;                // generations checked for allocations
+
+////////////////////////////////////////////////////////////////////////////////
+// Every heap allocation of the program goes through these, so the allocation
+// check can count them
+static std::atomic<long long unsigned> allocations(0);
+
+void* operator new(size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if(!p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+////////////////////////////////////////////////////////////////////////////////
+// Prints command line usage and exits
+void usage(char *prog)
+{
+  std::cerr << "Usage: " << prog << " [options] <instance>..." << std::endl;
+  std::cerr << "  -r, --reps N        timed batches of each kernel (default 5)" << std::endl;
+  std::cerr << "  -n, --nodes N       nodes explored by each explore batch (default 50000)" << std::endl;
+  std::cerr << "  -k, --kernels K,..  kernels to time (default all): get_cost, greedy_solution, k1k2," << std::endl;
+  std::cerr << "                      children, k3, k4, lower_bound, crossover, mutate, explore" << std::endl;
+  std::cerr << "  -s, --seed N        seed of the random inputs (default 0)" << std::endl;
+  std::cerr << "  -a, --allocations N instead of timing, counts heap allocations over N genetic" << std::endl;
+  std::cerr << "                      algorithm generations after a warm-up, and fails if any" << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Prints the statistics of the batches, as nanoseconds per call
+void report(const char* instance, const char* kernel, long long unsigned calls, std::vector<double>& seconds)
+{
+  std::sort(seconds.begin(), seconds.end());
+  double mean = std::accumulate(seconds.begin(), seconds.end(), 0.0) / seconds.size();
+  double median = seconds[seconds.size() / 2];
+  if(seconds.size() % 2 == 0) median = (median + seconds[seconds.size() / 2 - 1]) / 2;
+
+  double ns = 1e9 / std::max(calls, 1ULL);
+  printf("{\"instance\":\"%s\",\"kernel\":\"%s\",\"reps\":%d,\"calls\":%llu,"
+         "\"min_ns\":%.1f,\"median_ns\":%.1f,\"mean_ns\":%.1f,\"max_ns\":%.1f}\n",
+         instance, kernel, (int)seconds.size(), calls,
+         seconds.front() * ns, median * ns, mean * ns, seconds.back() * ns);
+  fflush(stdout);
+}
+
+// Times reps batches of calls to f(k), with as many calls per batch as needed
+// for MIN_BATCH seconds
+template< typename F > void time_kernel(const char* instance, const char* kernel, F f)
+{
+  auto batch = [&](long long unsigned calls) {
+    long long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(long long unsigned k=0; k < calls; k++) sum += f(k % INPUTS);
+    sink = sum;
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  long long unsigned calls = INPUTS;
+  while(batch(calls) < MIN_BATCH) calls *= 2;
+
+  std::vector<double> seconds;
+  for(int r=0; r < reps; r++) seconds.push_back(batch(calls));
+  report(instance, kernel, calls, seconds);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Random permutation of the scenes
+void random_order(prng& rng, std::vector<short>& order)
+{
+  order.resize(nscenes);
+  for(short i=0; i < nscenes; i++) order[i] = i;
+  for(short i=nscenes-1; i > 0; i--) std::swap(order[i], order[rng.below(i + 1)]);
+}
+
+// Random partial solution with depth scenes placed, alternating sides as the
+// search does
+void random_node(prng& rng, short depth, node* n)
+{
+  std::vector<short> order;
+  random_order(rng, order);
+
+  n->root();
+  for(short d=0; d < depth; d++) {
+    short idx = (n->lactive == nscenes - n->ractive) ? n->lactive++ : --n->ractive;
+    n->sol()[idx] = order[d];
+    bits_clear(n->comp(), order[d]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Times every selected kernel on the instance loaded
+void bench_instance(const char* instance, const std::set<std::string>& kernels)
+{
+  prng rng(seed);
+  auto wanted = [&](const char* kernel) { return kernels.empty() || kernels.count(kernel); };
+
+  node::setup(nscenes);
+  bound_setup();
+
+  // Complete solutions, and partial ones at every depth
+  std::vector<solution> full(INPUTS, solution(nscenes)), partial(INPUTS, solution(nscenes));
+  node_pool pool;
+  std::vector<node*> nodes(INPUTS);
+  std::vector<bound_state> states(INPUTS);
+  for(int k=0; k < INPUTS; k++) {
+    random_order(rng, full[k].sol);
+    full[k].comp.clear();
+    full[k].lactive = nscenes;
+
+    nodes[k] = pool.alloc();
+    random_node(rng, 1 + rng.below(nscenes - 1), nodes[k]);
+    nodes[k]->to_solution(partial[k]);
+    states[k].build(nodes[k]);
+  }
+
+  if(wanted("get_cost")) {
+    time_kernel(instance, "get_cost", [&](int k) { return get_cost(full[k]); });
+  }
+  if(wanted("greedy_solution")) {
+    solution sol(nscenes);
+    time_kernel(instance, "greedy_solution", [&](int k) { sol = partial[k]; greedy_solution(sol); return sol.lower_bound; });
+  }
+  if(wanted("k1k2")) {
+    bound_state state;
+    time_kernel(instance, "k1k2", [&](int k) { state.build(nodes[k]); return state.k1k2; });
+  }
+  if(wanted("children")) {
+    int ck1k2[MAX_BITS];
+    word_t sbl[MAX_WORDS], sbr[MAX_WORDS];
+    time_kernel(instance, "children", [&](int k) {
+      const node* n = nodes[k];
+      bool left = n->lactive == nscenes - n->ractive;
+      states[k].children(n->comp(), left ? n->lactive : n->ractive - 1, left, ck1k2, sbl, sbr);
+      return ck1k2[bits_first(n->comp(), nwords(nscenes))];
+    });
+  }
+  if(wanted("k3")) {
+    time_kernel(instance, "k3", [&](int k) { return k3(nodes[k]->comp(), states[k].bl); });
+  }
+  if(wanted("k4")) {
+    time_kernel(instance, "k4", [&](int k) { return k4(nodes[k]->comp(), states[k].br); });
+  }
+  if(wanted("lower_bound")) {
+    time_kernel(instance, "lower_bound", [&](int k) { return lower_bound(nodes[k]); });
+  }
+
+  // The genetic algorithm kernels run on a population of their own
+  ga_params params;
+  params.seed = seed;
+  const char* ga_kernels[] = { "crossover", "mutate" };
+  for(short m=0; m < 2; m++) {
+    if(!wanted(ga_kernels[m])) continue;
+
+    int count = INPUTS;
+    while(time_ga_kernel(m, count, params) < MIN_BATCH) count *= 2;
+
+    std::vector<double> seconds;
+    for(int r=0; r < reps; r++) seconds.push_back(time_ga_kernel(m, count, params));
+    report(instance, ga_kernels[m], count, seconds);
+  }
+
+  // Explores from the greedy solution, so every batch expands the same nodes
+  if(wanted("explore")) {
+    solution greedy(nscenes);
+    greedy_solution(greedy);
+
+    std::vector<double> seconds;
+    long long unsigned explored = 0;
+    for(int r=0; r < reps; r++) {
+      best_sol = greedy;
+      best_cost = greedy.lower_bound;
+
+      auto start = std::chrono::steady_clock::now();
+      explore(1, 0, 1, max_nodes);
+      seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+      explored = search_explored_nodes();
+    }
+    report(instance, "explore", explored, seconds);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Counts the heap allocations of the generations of every selection strategy,
+// once their buffers are warm. Returns whether there were none
+static long long unsigned warm_allocations;
+static void mark_warm() { warm_allocations = allocations.load(); }
+
+bool check_allocations(const char* instance)
+{
+  const char* names[] = { "roulette", "rank", "tournament" };
+  bool clean = true;
+  for(const char* name: names) {
+    ga_params params;
+    params.seed = seed;
+    parse_selection(name, params);
+
+    double seconds = time_ga_generations(WARMUP_GENERATIONS, generations, params, mark_warm);
+    long long unsigned count = allocations.load() - warm_allocations;
+    printf("{\"instance\":\"%s\",\"kernel\":\"generation\",\"selection\":\"%s\","
+           "\"generations\":%d,\"allocations\":%llu,\"mean_ns\":%.1f}\n",
+           instance, name, generations, count, seconds * 1e9 / generations);
+    fflush(stdout);
+    clean = clean && count == 0;
+  }
+  return clean;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main function. Times the kernels on each instance given
+int main(int argc, char **argv)
+{
+  std::set<std::string> kernels;
+
+  // Reads options
+  static struct option options[] = {
+    {"reps", required_argument, 0, 'r'},
+    {"nodes", required_argument, 0, 'n'},
+    {"kernels", required_argument, 0, 'k'},
+    {"seed", required_argument, 0, 's'},
+    {"allocations", required_argument, 0, 'a'},
+    {0, 0, 0, 0}
+  };
+  int opt;
+  while((opt = getopt_long(argc, argv, "r:n:k:s:a:", options, nullptr)) != -1) {
+    switch(opt) {
+      case 'r': reps = std::max(1, atoi(optarg)); break;
+      case 'n': max_nodes = std::max(1ULL, strtoull(optarg, nullptr, 10)); break;
+      case 'k': {
+        std::stringstream list(optarg);
+        std::string kernel;
+        while(std::getline(list, kernel, ',')) kernels.insert(kernel);
+        break;
+      }
+      case 's': seed = strtoull(optarg, nullptr, 10); break;
+      case 'a': generations = std::max(1, atoi(optarg)); break;
+      default: usage(argv[0]);
+    }
+  }
+  if(optind >= argc) usage(argv[0]);
+
+  bool clean = true;
+  for(int i=optind; i < argc; i++) {
+    read_input(argv[i], false);
+
+    const char* name = strrchr(argv[i], '/');
+    if(generations > 0) clean = check_allocations(name ? name + 1 : argv[i]) && clean;
+    else bench_instance(name ? name + 1 : argv[i], kernels);
+  }
+
+  if(!clean) {
+    std::cerr << "Genetic algorithm generations allocated memory after the warm-up" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -10,256 +10,153 @@
 
 #include "common.hpp"
 #include "metaheuristic.hpp"
+#include "search.hpp"
+#include "dp.hpp"
+#include "telemetry.hpp"
+#include "reduce.hpp"
 
-////////////////////////////////////////////////////////////////////////////////
-// BnB functions
-int lower_bound(solution& sol);
-void explore();
+#include <getopt.h>
 
 ////////////////////////////////////////////////////////////////////////////////
-// Main function. Reads input and call other methods
-int main(int argc, char **argv)
-{
-  // Sets output format to branch and bound
-  is_bnb = true;
-
-  // Signal handling
-  signal(SIGINT, print_and_exit);
-
-  // Read from input file
-  read_input(argv[1]);
-
-  // Lets do our heuristics first to find a good bound for the algorithm
-  genetic_algorithm(100);
 
-  // Creates tree root with empty solution
-  sol_tree.push_back(solution(nscenes));
-
-  // Explores solution tree and updates best solution so far
-  explore();
-
-  // Exploration is finished, prints and exit
-  print_and_exit();
-
-  return EXIT_SUCCESS;
-}
+const int GA_BOUND_TIME = 100; // Milliseconds of genetic algorithm before the search
 
 ////////////////////////////////////////////////////////////////////////////////
-// Computes the sum of k1 and k2 bounds as described in the paper
-int k1k2(solution& sol, std::vector<short>& bl, std::vector<short>& br)
+// Prints command line usage and exits
+void usage(char *prog)
 {
-  short lmost, rmost, lpartial, rpartial, partial;
-  int cost = 0;
-
-  for(short i=0; i < nactors; i++)
-  {
-    lmost = rmost = -1;
-    lpartial = rpartial = partial = 0;
-
-    // computes index of left most 1 in the scenes order and set it to lmost
-    // Also computes the right most 1 in the left set and set it to lrmost
-    short j, ac = 0;
-    for(j=0; j < sol.lactive; j++) { if(t[i][sol.sol[j]]) { lmost = j; break; } }
-    for(; j < sol.lactive; j++) {
-      if(t[i][sol.sol[j]]) { lpartial += ac; ac = 0; }
-      else ac++;
-    }
-
-    // computes index of right most 1 in the scenes order and set it to rmost
-    // Also computes the left most 1 in the right set and set it to rlmost
-    ac = 0;
-    for(j=sol.sol.size()-1; j >= sol.ractive; j--) { if(t[i][sol.sol[j]]) { rmost = j; break; } }
-    for(; j >= sol.ractive; j--) {
-      if(t[i][sol.sol[j]]) { rpartial += ac; ac = 0; }
-      else ac++;
-    }
-
-    // If the waiting time is totally defined
-    if(lmost != -1 && rmost != -1) {
-      partial = (rmost - lmost + 1 - wdays[i]);
-    }
-    // If only the left set is defined
-    else if(lmost != -1 && lpartial > 0) {
-      partial = lpartial;
-      bl.push_back(i);
-    }
-    // If only the right set is defined
-    else if(rmost != -1 && rpartial > 0) {
-      partial = rpartial;
-      br.push_back(i);
-    }
-
-    // Updates cost for each actor
-    cost += partial * costs[i];
-  }
-
-  return cost;
+  std::cerr << "Usage: " << prog << " [options] <instance>" << std::endl;
+  std::cerr << "  -t, --threads N     number of branch and bound threads (default 1)" << std::endl;
+  std::cerr << "  -d, --dp            solves by dynamic programming over scene sets instead" << std::endl;
+  std::cerr << "  -m, --memory MB     memory for open nodes, or for dynamic programming states (default 1024)" << std::endl;
+  std::cerr << "  -i, --islands N     number of genetic algorithm populations for the upper bound (default 1)" << std::endl;
+  std::cerr << "  -s, --seed N        seed of the genetic algorithm random numbers (default 0)" << std::endl;
+  std::cerr << "  -p, --population N  individuals on each population (default 25)" << std::endl;
+  std::cerr << "  -S, --selection S   parents selection: roulette, rank or tournament[:K] (default roulette, K 3)" << std::endl;
+  std::cerr << "  -l, --local MS      milliseconds of local search on each generation, 0 for none (default 0.5)" << std::endl;
+  std::cerr << "  -n, --no-background runs the genetic algorithm only before the search, not alongside it" << std::endl;
+  std::cerr << "  -g, --greedy G      nodes completed greedily: children, popped or depth:K for every K-th depth (default children)" << std::endl;
+  std::cerr << "  -T, --telemetry F   writes progress as JSON lines to file F, - for stderr or fd:N" << std::endl;
+  std::cerr << "  -R, --report S      seconds between telemetry records (default 1)" << std::endl;
+  std::cerr << "  -r, --raw           solves the instance as read, without reducing it" << std::endl;
+  std::cerr << "  -c, --checkpoint F  saves the search to file F periodically and when stopped by SIGINT or SIGTERM" << std::endl;
+  std::cerr << "  -k, --interval S    seconds between checkpoints (default 600)" << std::endl;
+  std::cerr << "  -u, --resume F      continues the search saved on file F, and checkpoints to it unless -c is given" << std::endl;
+  exit(EXIT_FAILURE);
 }
 
-// Computes Q set as defined in the paper
-void compute_Q(solution& sol, std::vector<short>& bl, std::vector<int>& Q)
+////////////////////////////////////////////////////////////////////////////////
+// Main function. Reads input and call other methods
+int main(int argc, char **argv)
 {
-  // List of tuples for (actors in the scene, scene cost)
-  using elem_t = std::pair<std::vector<short>, int>;
-  std::vector<elem_t> candidates;
-
-  // Computes number of actors in bl per scene
-  for(auto scene: sol.comp) {
-    std::vector<short> actors;
-    int cost = 0;
-
-    for(short actor: bl) {
-      if(t[actor][scene]) {
-        actors.push_back(actor);
-        cost += costs[actor];
-      }
+  short nthreads = 1;
+  bool use_dp = false;
+  size_t memory_mb = 1024;
+  ga_params params;
+  const char* telemetry = nullptr;
+  bool reduce = true;
+  double report = 1;
+  short greedy_depth = 1;
+  bool background = true;
+  const char* checkpoint = nullptr;
+  const char* resume = nullptr;
+  double interval = 600;
+
+  // Reads options
+  static struct option options[] = {
+    {"threads", required_argument, 0, 't'},
+    {"dp", no_argument, 0, 'd'},
+    {"memory", required_argument, 0, 'm'},
+    {"islands", required_argument, 0, 'i'},
+    {"seed", required_argument, 0, 's'},
+    {"population", required_argument, 0, 'p'},
+    {"selection", required_argument, 0, 'S'},
+    {"local", required_argument, 0, 'l'},
+    {"no-background", no_argument, 0, 'n'},
+    {"greedy", required_argument, 0, 'g'},
+    {"telemetry", required_argument, 0, 'T'},
+    {"report", required_argument, 0, 'R'},
+    {"raw", no_argument, 0, 'r'},
+    {"checkpoint", required_argument, 0, 'c'},
+    {"interval", required_argument, 0, 'k'},
+    {"resume", required_argument, 0, 'u'},
+    {0, 0, 0, 0}
+  };
+  int opt;
+  while((opt = getopt_long(argc, argv, "t:dm:i:s:p:S:l:ng:T:R:rc:k:u:", options, nullptr)) != -1) {
+    switch(opt) {
+      case 't': nthreads = std::max(1, atoi(optarg)); break;
+      case 'd': use_dp = true; break;
+      case 'm': memory_mb = std::max(1, atoi(optarg)); break;
+      case 'i': params.nislands = std::max(1, atoi(optarg)); break;
+      case 's': params.seed = strtoull(optarg, nullptr, 10); break;
+      case 'p': params.population = std::max(1, atoi(optarg)); break;
+      case 'S': if(!parse_selection(optarg, params)) usage(argv[0]); break;
+      case 'l': params.search_budget = std::max(0.0, atof(optarg)); break;
+      case 'n': background = false; break;
+      case 'g':
+        if(strcmp(optarg, "children") == 0) greedy_depth = 1;
+        else if(strcmp(optarg, "popped") == 0) greedy_depth = 0;
+        else if(strncmp(optarg, "depth:", 6) == 0) greedy_depth = std::max(1, atoi(optarg + 6));
+        else usage(argv[0]);
+        break;
+      case 'T': telemetry = optarg; break;
+      case 'R': report = std::max(0.001, atof(optarg)); break;
+      case 'r': reduce = false; break;
+      case 'c': checkpoint = optarg; break;
+      case 'k': interval = std::max(0.001, atof(optarg)); break;
+      case 'u': resume = optarg; break;
+      default: usage(argv[0]);
     }
-
-    if(cost > 0) // only add candidates with positive costs
-      candidates.push_back(std::make_pair(actors, cost));
   }
+  if(optind >= argc) usage(argv[0]);
+  if(use_dp && (checkpoint || resume)) usage(argv[0]);
+  if(resume && !checkpoint) checkpoint = resume;
 
-  // Sorts scenes in increasing order of number of actors per scene. Use costs as tie breaker
-  std::sort(candidates.begin(), candidates.end(), [](const elem_t& i, const elem_t& j)
-  {
-    int si = i.first.size(), sj = j.first.size();
-    return (si == sj) ? i.second < j.second : si < sj;
-  });
-
-  // Now lets set the Q set.
-
-  // It serves for not adding two scenes with the same actor to Q
-  std::vector<bool> used_actors(nactors, false);
-  // iterates over the scenes candidates
-  for(auto& candidate: candidates)
-  {
-    bool add_scene = true; // always try to add scene
-
-    // Checks if an actor was used in this scene before, and add it to used actors
-    for(short actor: candidate.first) {
-      if(used_actors[actor]) add_scene = false;
-      used_actors[actor] = true;
-    }
-
-    // If none of the actors of this scene were used yet, try adding the scene
-    if(add_scene) Q.push_back(candidate.second); // adds the scene cost
+  // Sets output format to branch and bound
+  is_bnb = true;
+  dual_bound = use_dp ? dp_dual_bound : search_dual_bound;
+  explored_nodes = use_dp ? dp_explored_nodes : search_explored_nodes;
+  open_nodes = use_dp ? nullptr : search_open_nodes;
+  report_stats = use_dp ? nullptr : search_report;
+
+  // Progress goes to its own stream, stdout only gets the result
+  if(telemetry && !telemetry_open(telemetry, report)) {
+    std::cerr << "Cannot open telemetry stream " << telemetry << std::endl;
+    exit(EXIT_FAILURE);
   }
 
-  std::sort(Q.begin(), Q.end(), [](int a, int b) { return a >= b; });
-}
-
-// Computes k3 as defined in the paper
-int k3(solution& sol, std::vector<short>& bl)
-{
-  std::vector<int> Q;
-  int cost = 0;
-
-  // Computes Q according to the description of the problem in decreasing weight
-  compute_Q(sol, bl, Q);
-
-  // Computes the cost
-  for(int i=0; i < (int)Q.size(); i++) cost += i * Q[i];
-
-  return cost;
-}
-
-// Computes k4 as defined in the paper
-int k4(solution& sol, std::vector<short>& br)
-{
-  std::vector<int> Q;
-  int cost = 0;
-
-  // Computes Q according to the description of the problem in decreasing weight
-  compute_Q(sol, br, Q);
-
-  // Computes the cost
-  for(int i=0; i < (int)Q.size(); i++) cost += i * Q[i];
-
-  return cost;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-// Computes the lower bound by using the function described on the pdf by
-// computing the acummulated sum of k1,k2,k3 and k4.
-int lower_bound(solution& sol)
-{
-  std::vector<short> bl, br;
-
-  int bound = k1k2(sol, bl, br);
-  if(bl.size() > 1) bound += k3(sol, bl); // no need to compute k3 when bl has one single element
-  if(br.size() > 1) bound += k4(sol, br); // no need to compute k3 when br has one single element
+  // Signal handling. The solvers are asked to stop and the result is printed
+  // once they return, after saving the open nodes when checkpointing
+  signal(SIGINT, request_stop);
+  if(checkpoint) signal(SIGTERM, request_stop);
 
-  return bound;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-// Explores the solution tree by using branch and bound - best fit
-void explore()
-{
-  while(sol_tree.size() > 0 && sol_tree.front().lower_bound < best_sol.lower_bound)
-  {
-    // If we've found a possible solution
-    if(sol_tree.front().comp.size() == 0)
-    {
-      // If the solution is actually better
-      if(sol_tree.front().lower_bound < best_sol.lower_bound) {
-        // the solution is actually better
-        update_solution(sol_tree.front());
-      }
-
-      // pop from heap
-      std::pop_heap(sol_tree.begin(), sol_tree.end());
-      sol_tree.pop_back();
-    } else
-    {
-      // Increase number of explored nodes
-      nexplored++;
-
-      int st_size = sol_tree.size(), idx = -1, min = -1;
-
-      if(sol_tree.front().lactive == (short)sol_tree.front().sol.size() - sol_tree.front().ractive) {
-        idx = ++sol_tree.front().lactive-1; // insert on the left
-      } else {
-        idx = --sol_tree.front().ractive; // insert on the right
-        min = (sol_tree.front().ractive == (short)sol_tree.front().sol.size()-1) ? sol_tree.front().sol[sol_tree.front().lactive-1] : -1;
-      }
-
-      // for each possible scene, creates a new solution with it and inserts it
-      // into the solution tree if its lower bound allows
-      for(short it=0; it < (short)sol_tree.front().comp.size(); it++) {
-        short scene = sol_tree.front().comp[it];
-
-        if(min < scene) { // This if breaks simetry of solutions
-          // Creates the new partial solution candidate
-          solution new_node(sol_tree.front());
-          new_node.comp.erase(new_node.comp.begin()+it, new_node.comp.begin()+it+1);
-          new_node.sol[idx] = scene;
-
-          // std::cerr << new_node.sol.size() << std::endl;
-
-          new_node.lower_bound = lower_bound(new_node);
-
-          // Completes the partial solution candidate by using a greedy algorithm
-          solution greedy(new_node);
-          greedy_solution(greedy);
+  // Read from input file
+  read_input(argv[optind], reduce);
+  if(reduce) reduction_report();
+
+  // Restores the best solution and open nodes of a search saved before
+  if(checkpoint) search_checkpoint(checkpoint, interval);
+  if(resume) search_resume(resume);
+
+  // Lets do our heuristics first to find a good bound for the algorithm. By
+  // default they keep improving it alongside the search, seeded by its nodes
+  if(background) {
+    ga_start(params);
+    std::this_thread::sleep_for(std::chrono::milliseconds(GA_BOUND_TIME));
+  } else {
+    genetic_algorithm(GA_BOUND_TIME, params);
+  }
 
-          // mature node condition
-          if(new_node.lower_bound < greedy.lower_bound && new_node.lower_bound < best_sol.lower_bound) sol_tree.push_back(new_node);
-          // If greedy is better than current, update best solution so far
-          if(greedy.lower_bound < best_sol.lower_bound) update_solution(greedy);
-        }
-      }
+  // Explores solution tree (or scene sets) and updates best solution so far
+  if(use_dp) dp_solve(memory_mb);
+  else explore(nthreads, memory_mb, greedy_depth);
+  ga_stop();
 
-      // pop from heap
-      std::pop_heap(sol_tree.begin(), sol_tree.end());
-      sol_tree.pop_back();
+  // Exploration is finished, prints and exit
+  print_and_exit();
 
-      // updates heap with freshly added nodes
-      for(int it = std::max(st_size-1, 1); it < (int)sol_tree.size(); it++) {
-        std::push_heap(sol_tree.begin(), sol_tree.begin()+it);
-      }
-    }
-  }
+  return EXIT_SUCCESS;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,268 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: bound.cpp
+//
+//  @brief Lower bounds for the branch and bound algorithm.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bound.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Actors of each scene as a dense row of masks, all ones for the actors in it,
+// so the sum of a value over the actors of a scene is a branch free loop
+static std::vector<int> dense;
+static short stride; // row length, nactors rounded up to a multiple of 8
+
+void bound_setup()
+{
+  stride = (nactors + 7) / 8 * 8;
+  dense.assign((size_t)nscenes * stride, 0);
+  for(short scene=0; scene < nscenes; scene++)
+    for(short i=0; i < nactors; i++)
+      if(bits_test(scene_actors[scene], i)) dense[scene * stride + i] = -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void bound_state::build(const node* sol)
+{
+  const short words = scene_actors.words;
+
+  for(short i=0; i < nactors; i++) {
+    lmost[i] = llast[i] = rmost[i] = rfirst[i] = -1;
+    lpartial[i] = rpartial[i] = 0;
+  }
+  std::fill(bl, bl + words, 0);
+  std::fill(br, br + words, 0);
+  k1k2 = 0;
+
+  // Left set grows to the right and right set grows to the left
+  for(short j=0; j < sol->lactive; j++) place(sol->sol()[j], j, true);
+  for(short j=nscenes-1; j >= sol->ractive; j--) place(sol->sol()[j], j, false);
+}
+
+void bound_state::place(short scene, short idx, bool left)
+{
+  k1k2 = child(scene, idx, left, bl, br);
+
+  const word_t* actors = scene_actors[scene];
+  for(short w=0; w < scene_actors.words; w++) {
+    for(word_t b = actors[w]; b; b &= b - 1) {
+      short i = w * WORD_BITS + __builtin_ctzll(b);
+      update(i, idx, left, lmost[i], llast[i], lpartial[i], rmost[i], rfirst[i], rpartial[i]);
+    }
+  }
+}
+
+int bound_state::child(short scene, short idx, bool left, word_t* cbl, word_t* cbr) const
+{
+  const word_t* actors = scene_actors[scene];
+  int cost = k1k2;
+
+  if(cbl != bl) std::copy(bl, bl + scene_actors.words, cbl);
+  if(cbr != br) std::copy(br, br + scene_actors.words, cbr);
+
+  // Only actors of the new scene have their summary changed
+  for(short w=0; w < scene_actors.words; w++) {
+    for(word_t b = actors[w]; b; b &= b - 1) {
+      short i = w * WORD_BITS + __builtin_ctzll(b), lm, ll, lp, rm, rf, rp, side;
+
+      cost -= partial(i, lmost[i], lpartial[i], rmost[i], rpartial[i], side) * costs[i];
+
+      update(i, idx, left, lm, ll, lp, rm, rf, rp);
+      cost += partial(i, lm, lp, rm, rp, side) * costs[i];
+
+      bits_clear(cbl, i);
+      bits_clear(cbr, i);
+      if(side == 1) bits_set(cbl, i);
+      if(side == 2) bits_set(cbr, i);
+    }
+  }
+
+  return cost;
+}
+
+void bound_state::children(const word_t* comp, short idx, bool left, int* ck1k2, word_t* sbl, word_t* sbr) const
+{
+  int delta[MAX_BITS];
+
+  std::fill(sbl, sbl + scene_actors.words, 0);
+  std::fill(sbr, sbr + scene_actors.words, 0);
+
+  // Change of k1 + k2 when actor i works at idx
+  for(short i=0; i < nactors; i++) {
+    short lm, ll, lp, rm, rf, rp, side;
+
+    delta[i] = -partial(i, lmost[i], lpartial[i], rmost[i], rpartial[i], side) * costs[i];
+
+    update(i, idx, left, lm, ll, lp, rm, rf, rp);
+    delta[i] += partial(i, lm, lp, rm, rp, side) * costs[i];
+
+    if(side == 1) bits_set(sbl, i);
+    if(side == 2) bits_set(sbr, i);
+  }
+  std::fill(delta + nactors, delta + stride, 0);
+
+  // Each child adds the changes of its actors
+  for(short scene=0; scene < nscenes; scene++) {
+    if(!bits_test(comp, scene)) continue;
+
+    const int* actors = &dense[scene * stride];
+    int sum = 0;
+    for(short i=0; i < stride; i++) sum += actors[i] & delta[i];
+
+    ck1k2[scene] = k1k2 + sum;
+  }
+}
+
+void bound_state::child_sets(short scene, const word_t* sbl, const word_t* sbr, word_t* cbl, word_t* cbr) const
+{
+  const word_t* actors = scene_actors[scene];
+
+  for(short w=0; w < scene_actors.words; w++) {
+    cbl[w] = (bl[w] & ~actors[w]) | (sbl[w] & actors[w]);
+    cbr[w] = (br[w] & ~actors[w]) | (sbr[w] & actors[w]);
+  }
+}
+
+int bound_state::completion(const word_t* comp, short day, short scene, short idx, bool left) const
+{
+  short first[MAX_BITS], last[MAX_BITS];
+
+  // First and last days of each actor among the filled days
+  for(short i=0; i < nactors; i++) first[i] = last[i] = -1;
+  for(short s: greedy_order) {
+    if(!bits_test(comp, s)) continue;
+
+    for(short w=0; w < scene_actors.words; w++) {
+      for(word_t b = scene_actors[s][w]; b; b &= b - 1) {
+        short i = w * WORD_BITS + __builtin_ctzll(b);
+        if(first[i] == -1) first[i] = day;
+        last[i] = day;
+      }
+    }
+    day++;
+  }
+
+  // Spans start on the left set and end on the right set when the actor works
+  // there, on the filled days otherwise
+  int cost = 0;
+  for(short i=0; i < nactors; i++) {
+    if(wdays[i] == 0) continue;
+
+    short lm = lmost[i], ll = llast[i], lp, rm = rmost[i], rf = rfirst[i], rp;
+    if(scene != -1 && bits_test(scene_actors[scene], i)) update(i, idx, left, lm, ll, lp, rm, rf, rp);
+
+    short f = (lm != -1) ? lm : (first[i] != -1) ? first[i] : rf;
+    short l = (rm != -1) ? rm : (last[i] != -1) ? last[i] : ll;
+    cost += (l - f + 1 - wdays[i]) * costs[i];
+  }
+
+  return cost;
+}
+
+// Computes Q set as defined in the paper, on Q in decreasing order. Returns the
+// size of Q
+static short compute_Q(const word_t* comp, const word_t* mask, int* Q)
+{
+  const short words = scene_actors.words;
+
+  // Candidate scenes by their actors in mask: how many and their cost
+  struct candidate_t { short scene, actors; int cost; };
+  candidate_t candidates[MAX_BITS];
+  short ncandidates = 0;
+
+  for(short w=0; w < nwords(nscenes); w++) {
+    for(word_t s = comp[w]; s; s &= s - 1) {
+      short scene = w * WORD_BITS + __builtin_ctzll(s), actors = 0;
+      int cost = 0;
+
+      for(short v=0; v < words; v++) {
+        for(word_t b = scene_actors[scene][v] & mask[v]; b; b &= b - 1, actors++) {
+          cost += costs[v * WORD_BITS + __builtin_ctzll(b)];
+        }
+      }
+
+      if(cost > 0) // only add candidates with positive costs
+        candidates[ncandidates++] = { scene, actors, cost };
+    }
+  }
+
+  // Sorts scenes in increasing order of number of actors per scene. Use costs as tie breaker
+  std::sort(candidates, candidates + ncandidates, [](const candidate_t& i, const candidate_t& j)
+  {
+    return (i.actors == j.actors) ? i.cost < j.cost : i.actors < j.actors;
+  });
+
+  // Now lets set the Q set. Scenes sharing an actor with an earlier candidate
+  // are left out, and their actors are marked as used anyway
+  word_t used[MAX_WORDS] = {0};
+  short size = 0;
+  for(short c=0; c < ncandidates; c++) {
+    const word_t* actors = scene_actors[candidates[c].scene];
+    bool add_scene = true;
+
+    for(short w=0; w < words; w++) {
+      if(actors[w] & mask[w] & used[w]) add_scene = false;
+      used[w] |= actors[w] & mask[w];
+    }
+
+    if(add_scene) Q[size++] = candidates[c].cost; // adds the scene cost
+  }
+
+  std::sort(Q, Q + size, std::greater<int>());
+
+  return size;
+}
+
+// Sum of the scene costs of Q weighted by their position
+static int Q_cost(const word_t* comp, const word_t* mask)
+{
+  int Q[MAX_BITS];
+  short size = compute_Q(comp, mask, Q);
+
+  int cost = 0;
+  for(short i=0; i < size; i++) cost += i * Q[i];
+
+  return cost;
+}
+
+// Computes k3 as defined in the paper
+int k3(const word_t* comp, const word_t* bl)
+{
+  return Q_cost(comp, bl);
+}
+
+// Computes k4 as defined in the paper
+int k4(const word_t* comp, const word_t* br)
+{
+  return Q_cost(comp, br);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Computes the lower bound by using the function described on the pdf by
+// computing the acummulated sum of k1,k2,k3 and k4.
+int lower_bound(const word_t* comp, const word_t* bl, const word_t* br, int k1k2)
+{
+  int bound = k1k2;
+  if(bits_count(bl, scene_actors.words) > 1) bound += k3(comp, bl); // no need to compute k3 when bl has one single element
+  if(bits_count(br, scene_actors.words) > 1) bound += k4(comp, br); // no need to compute k3 when br has one single element
+
+  return bound;
+}
+
+int lower_bound(const node* sol, const word_t* bl, const word_t* br, int k1k2)
+{
+  return lower_bound(sol->comp(), bl, br, k1k2);
+}
+
+int lower_bound(const node* sol)
+{
+  bound_state state;
+  state.build(sol);
+
+  return lower_bound(sol, state.bl, state.br, state.k1k2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
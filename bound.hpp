@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: bound.hpp
+//
+//  @brief Lower bounds for the branch and bound algorithm.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOUND_HPP
+#define BOUND_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "node.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Per actor summary of the left and right sets of a partial solution, from which
+// the k1 and k2 bounds and the bl/br sets are read. A child differs from its
+// parent by a single scene, so its summary is derived from the parent's by
+// touching only the actors of that scene
+class bound_state
+{
+public:
+  short lmost[MAX_BITS], llast[MAX_BITS], lpartial[MAX_BITS]; // first and last positions in the left set and waiting inside it
+  short rmost[MAX_BITS], rfirst[MAX_BITS], rpartial[MAX_BITS]; // last and first positions in the right set and waiting inside it
+  word_t bl[MAX_WORDS], br[MAX_WORDS]; // actors only in the left (right) set with some waiting
+  int k1k2; // sum of k1 and k2 bounds
+
+  // Builds the summary of sol from scratch
+  void build(const node* sol);
+
+  // Adds scene at position idx of the left (or right) set
+  void place(short scene, short idx, bool left);
+
+  // Computes k1 + k2 and the bl/br sets of the child with scene at position
+  // idx, without changing this summary
+  int child(short scene, short idx, bool left, word_t* cbl, word_t* cbr) const;
+
+  // Computes k1 + k2 of every child with a scene of comp at position idx at
+  // once, indexed by scene on ck1k2. An actor changes the same way whichever
+  // scene brings it to idx, so its change is computed once and each child sums
+  // those of its actors. Sets on sbl (sbr) the actors that would be in bl (br)
+  // if brought to idx
+  void children(const word_t* comp, short idx, bool left, int* ck1k2, word_t* sbl, word_t* sbr) const;
+
+  // The bl/br sets of the child with scene, from those given by children
+  void child_sets(short scene, const word_t* sbl, const word_t* sbr, word_t* cbl, word_t* cbr) const;
+
+  // Cost of the greedy completion of the child with scene at position idx, or
+  // of this node if scene is -1: the days from day on are filled with the
+  // scenes of comp in greedy_order. Only those days are scanned, the ends of
+  // the left and right sets come from the summary
+  int completion(const word_t* comp, short day, short scene, short idx, bool left) const;
+
+private:
+  // Updates the summary of actor i with a new working day at idx
+  inline void update(short i, short idx, bool left, short& lm, short& ll, short& lp, short& rm, short& rf, short& rp) const
+  {
+    lm = lmost[i]; ll = llast[i]; lp = lpartial[i];
+    rm = rmost[i]; rf = rfirst[i]; rp = rpartial[i];
+
+    if(left) {
+      if(lm == -1) lm = idx;
+      else lp += idx - ll - 1;
+      ll = idx;
+    } else {
+      if(rm == -1) rm = idx;
+      else rp += rf - idx - 1;
+      rf = idx;
+    }
+  }
+
+  // Waiting days of actor i accounted by k1 and k2. Sets side to 1 (2) if
+  // the actor belongs to bl (br)
+  static inline short partial(short i, short lm, short lp, short rm, short rp, short& side)
+  {
+    side = 0;
+
+    // If the waiting time is totally defined
+    if(lm != -1 && rm != -1) return rm - lm + 1 - wdays[i];
+    // If only the left set is defined
+    if(lm != -1 && lp > 0) { side = 1; return lp; }
+    // If only the right set is defined
+    if(rm != -1 && rp > 0) { side = 2; return rp; }
+
+    return 0;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Computes k3 (k4) as defined in the paper for the scenes in comp and the
+// actors in bl (br)
+int k3(const word_t* comp, const word_t* bl);
+int k4(const word_t* comp, const word_t* br);
+
+// Builds the tables shared by the bounds of an instance. Called once, before
+// any bound_state::children
+void bound_setup();
+
+// Computes the lower bound of a node with scenes comp still to be added, given
+// its bl/br sets and k1 + k2
+int lower_bound(const word_t* comp, const word_t* bl, const word_t* br, int k1k2);
+
+// Computes the lower bound of sol given its bl/br sets and k1 + k2
+int lower_bound(const node* sol, const word_t* bl, const word_t* br, int k1k2);
+
+// Computes the lower bound of sol from scratch
+int lower_bound(const node* sol);
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* BOUND_HPP */
+
+////////////////////////////////////////////////////////////////////////////////
@@ -1,6 +1,29 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "common.hpp"
+#include "instance.hpp"
+#include "reduce.hpp"
+#include "telemetry.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+void bitmatrix::resize(short rows, short cols)
+{
+  const size_t line = 64; // cache line size
+
+  this->rows = rows;
+  this->cols = cols;
+  this->words = nwords(cols);
+
+  // Allocates whole cache lines so the matrix never shares a line with other data
+  size_t bytes = (size_t)rows * this->words * sizeof(word_t);
+  bytes = std::max(line, (bytes + line - 1) / line * line);
+
+  free(this->data);
+  this->data = nullptr;
+  if(posix_memalign((void**)&this->data, line, bytes) != 0) throw std::bad_alloc();
+  memset(this->data, 0, bytes);
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -37,96 +60,112 @@ solution& solution::operator=(const solution& other)
 // Global variables
 std::mutex sol_lock;  // Solution mutex
 solution best_sol; // best solution so far
+std::atomic<int> best_cost(INT_MAX); // cost of best_sol, readable without the lock
+std::atomic<bool> stop_requested(false); // asks the solvers to return with what they found
 
-std::vector<std::vector<bool>> t; // t matrix
+bitmatrix t; // t matrix, one row of scenes per actor
+bitmatrix scene_actors; // transposed t matrix, one row of actors per scene
 std::vector<int> costs, scene_costs; // cost array for each actor
+std::vector<short> greedy_order; // scenes in decreasing order of scene cost
 std::vector<short> wdays;
 short nscenes, nactors; // number of scenes and actors
-long long unsigned nexplored = 0; // number of explored nodes
 
-std::vector<solution> sol_tree; // solution tree (min-heap)
+int (*dual_bound)() = nullptr;
+long long unsigned (*explored_nodes)() = nullptr;
+long long (*open_nodes)() = nullptr;
+void (*report_stats)() = nullptr;
 
 bool is_bnb = false;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void read_input(char *filename)
+void read_input(char *filename, bool reduce)
 {
-  // Open input file
-  std::ifstream input(filename, std::ios_base::in);
-
-  // Reads parameters (scenes, actors)
-  input >> nscenes >> nactors;
-
-  // Reads scenesXactors matrix
-  t.resize(nactors);
-  wdays.assign(nactors, 0);
-  for(short i=0; i < nactors; i++) {
-    t[i].resize(nscenes);
-    for(short j=0; j < nscenes; j++) {
-      bool isin;
-
-      input >> isin;
-      t[i][j] = isin;
-
-      if(isin) wdays[i]++; // total number of working days per actor
-    }
-  }
-
-  // Reads actors costs
-  costs.resize(nactors);
-  for(short i=0; i < nactors; i++) {
-    short c;
+  // Reads parameters, the scenes x actors matrix in both layouts and the costs
+  load_instance(filename);
+  if(reduce) reduce_instance();
 
-    input >> c;
-    costs[i] = c;
-  }
+  // Total number of working days per actor
+  wdays.resize(nactors);
+  for(short i=0; i < nactors; i++) wdays[i] = bits_count(t[i], t.words);
 
   // Calculate total cost for each day
   scene_costs.resize(nscenes);
   for(short j=0; j < nscenes; j++) {
     scene_costs[j] = 0;
-    for(short i=0; i < nactors; i++) {
-      if (t[i][j]) {
-        scene_costs[j] += costs[i];
+    for(short w=0; w < scene_actors.words; w++) {
+      for(word_t b = scene_actors[j][w]; b; b &= b - 1) {
+        scene_costs[j] += costs[w * WORD_BITS + __builtin_ctzll(b)];
       }
     }
   }
+
+  // Order of the greedy completions, ties broken by scene index
+  greedy_order.resize(nscenes);
+  for(short j=0; j < nscenes; j++) greedy_order[j] = j;
+  std::stable_sort(greedy_order.begin(), greedy_order.end(), [](short i, short j) { return scene_costs[i] > scene_costs[j]; });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Prints solution and exits
-void print_and_exit(int signum)
+// Prints solution and exits. Not a signal handler, it takes locks and
+// allocates: the signals go to request_stop instead
+void print_and_exit()
 {
   // Acquires lock
   sol_lock.lock();
 
-  // Prints solution
-  std::cout << best_sol.sol << std::endl << best_sol.lower_bound << std::endl;
+  // Prints solution, on the scenes as read
+  std::cout << restore_solution(best_sol.sol) << std::endl << best_sol.lower_bound << std::endl;
 
   if(is_bnb) {
-    int dual = sol_tree.size() > 0 ? sol_tree.front().lower_bound : best_sol.lower_bound;
+    int dual = dual_bound();
 
     std::cout << std::min(best_sol.lower_bound, dual) << std::endl;
-    std::cout << nexplored << std::endl;
+    std::cout << explored_nodes() << std::endl;
   }
+  if(report_stats) report_stats();
+  telemetry_close();
 
-  // Exits
-  exit(EXIT_SUCCESS);
+  // Exits without running destructors, search threads may still be running
+  std::cout.flush();
+  _exit(EXIT_SUCCESS);
 
   // Should never reach this point
   sol_lock.unlock();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Updates the solution in a safe way with lockers !!!
-void update_solution(const solution& newsol)
+// Signal handler that asks the solvers to return with what they found. A
+// second signal ends the process at once
+void request_stop(int signum)
 {
+  stop_requested = true;
+  signal(signum, SIG_DFL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Updates the solution in a safe way with lockers !!! Only replaces the best
+// solution if newsol is better, and returns whether it was
+bool update_solution(const solution& newsol)
+{
+  bool better = false;
+
+  // Most candidates are rejected without taking the lock
+  if(newsol.lower_bound >= best_cost.load()) return false;
+
   sol_lock.lock();
 
-  best_sol = newsol;
+  if(newsol.lower_bound < best_cost.load()) {
+    best_sol = newsol;
+    best_cost.store(newsol.lower_bound);
+    better = true;
+  }
 
   sol_lock.unlock();
+
+  if(better) telemetry_event("incumbent");
+
+  return better;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,75 @@
 
 #include <bits/stdc++.h>
 
+////////////////////////////////////////////////////////////////////////////////
+// Bit sets are stored as arrays of 64 bits words. Instances are limited to
+// MAX_BITS scenes and actors so kernels can keep their scratch sets on the stack
+typedef uint64_t word_t;
+
+const short WORD_BITS = 64;
+const short MAX_BITS = 256;
+const short MAX_WORDS = MAX_BITS / WORD_BITS;
+
+// Number of words needed to store n bits
+inline short nwords(short n) { return (n + WORD_BITS - 1) / WORD_BITS; }
+
+inline bool bits_test(const word_t* b, short i) { return (b[i / WORD_BITS] >> (i % WORD_BITS)) & 1; }
+inline void bits_set(word_t* b, short i) { b[i / WORD_BITS] |= word_t(1) << (i % WORD_BITS); }
+inline void bits_clear(word_t* b, short i) { b[i / WORD_BITS] &= ~(word_t(1) << (i % WORD_BITS)); }
+
+// Index of the lowest set bit, or -1 if the set is empty
+inline short bits_first(const word_t* b, short words)
+{
+  for(short w=0; w < words; w++)
+    if(b[w]) return w * WORD_BITS + __builtin_ctzll(b[w]);
+  return -1;
+}
+
+// Index of the highest set bit, or -1 if the set is empty
+inline short bits_last(const word_t* b, short words)
+{
+  for(short w=words-1; w >= 0; w--)
+    if(b[w]) return w * WORD_BITS + WORD_BITS - 1 - __builtin_clzll(b[w]);
+  return -1;
+}
+
+// Number of set bits
+inline short bits_count(const word_t* b, short words)
+{
+  short c = 0;
+  for(short w=0; w < words; w++) c += __builtin_popcountll(b[w]);
+  return c;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Packed bit matrix. Rows are stored contiguously as arrays of words and the
+// storage is aligned to a cache line
+class bitmatrix
+{
+public:
+  short rows, cols; // matrix dimensions
+  short words;      // words per row
+
+  bitmatrix() : rows(0), cols(0), words(0), data(nullptr) {}
+  ~bitmatrix() { free(data); }
+
+  // Resizes the matrix and clears all bits
+  void resize(short rows, short cols);
+
+  // Row accessors
+  inline word_t* operator[](short r) { return data + r * words; }
+  inline const word_t* operator[](short r) const { return data + r * words; }
+
+  inline bool test(short r, short c) const { return bits_test((*this)[r], c); }
+  inline void set(short r, short c) { bits_set((*this)[r], c); }
+
+private:
+  word_t *data;
+
+  bitmatrix(const bitmatrix&);
+  bitmatrix& operator=(const bitmatrix&);
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // This class is the used class in the generic solution for the bnb algorithm
 // It uses the lower_bound and evaluate functions to define how the bnb algorithm will
@@ -34,25 +103,31 @@ public:
 
 ////////////////////////////////////////////////////////////////////////////////
 // Auxiliary functions
-void read_input(char *filename);
-void print_and_exit(int signum=0);
-void update_solution(const solution& new_node);
+void read_input(char *filename, bool reduce=true);
+void print_and_exit();
+void request_stop(int signum);
+bool update_solution(const solution& new_node);
 
 ////////////////////////////////////////////////////////////////////////////////
 // Global variables
 extern std::mutex sol_lock;  // Solution mutex
 extern solution best_sol; // best solution so far
+extern std::atomic<int> best_cost; // cost of best_sol, readable without the lock
+extern std::atomic<bool> stop_requested; // asks the solvers to return with what they found
 
-extern std::vector<std::vector<bool>> t; // t matrix
+extern bitmatrix t; // t matrix, one row of scenes per actor
+extern bitmatrix scene_actors; // transposed t matrix, one row of actors per scene
 extern std::vector<int> costs, scene_costs; // cost array for each actor
+extern std::vector<short> greedy_order; // scenes in decreasing order of scene cost
 extern std::vector<short> wdays;
 extern short nscenes, nactors; // number of scenes and actors
-extern long long unsigned nexplored; // number of explored nodes on tree
 
-// Necessary for branch and bound algorithm
-// Solutions tree. Each node is made of a solution and it's lower bound.
-// In the leafs, the lower bound equals the cost of that solution
-extern std::vector<solution> sol_tree;
+// Necessary for branch and bound algorithm. They report the best known lower
+// bound and the number of explored nodes of the search
+extern int (*dual_bound)();
+extern long long unsigned (*explored_nodes)();
+extern long long (*open_nodes)(); // nodes waiting to be explored, if set
+extern void (*report_stats)(); // prints search statistics on stderr, if set
 
 extern bool is_bnb;
 
@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: convert.cpp
+//
+//  @brief Converts instances between the text, dat and binary formats.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "instance.hpp"
+
+#include <getopt.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Prints command line usage and exits
+void usage(char *prog)
+{
+  std::cerr << "Usage: " << prog << " [options] <input> <output>" << std::endl;
+  std::cerr << "  -f, --format F      format of the output: text, dat or bin (default by its extension)" << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main function. Reads an instance in any format and writes it in another
+int main(int argc, char **argv)
+{
+  const char* format = nullptr;
+
+  // Reads options
+  static struct option options[] = {
+    {"format", required_argument, 0, 'f'},
+    {0, 0, 0, 0}
+  };
+  int opt;
+  while((opt = getopt_long(argc, argv, "f:", options, nullptr)) != -1) {
+    switch(opt) {
+      case 'f':
+        if(strcmp(optarg, "text") && strcmp(optarg, "dat") && strcmp(optarg, "bin")) usage(argv[0]);
+        format = optarg;
+        break;
+      default: usage(argv[0]);
+    }
+  }
+  if(optind + 2 != argc) usage(argv[0]);
+
+  load_instance(argv[optind]);
+  save_instance(argv[optind + 1], format_named(format ? format : argv[optind + 1]));
+
+  return EXIT_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,300 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: dp.cpp
+//
+//  @brief Exact solver by dynamic programming over the set of scheduled scenes.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "dp.hpp"
+#include "bound.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Memoized state. States are keyed by the set of remaining scenes, which is
+// never empty, so a zero key marks a free slot
+struct dp_entry
+{
+  uint64_t key;  // remaining scenes
+  int value;     // exact cost of the remaining scenes, or a lower bound of it
+  bool exact;    // whether value is exact
+};
+
+const short PROBES = 8; // slots looked at for each state
+const long long unsigned PUBLISH_EVERY = 4096; // states expanded between updates of the dual bound
+
+static dp_entry *table = nullptr;
+static uint64_t table_mask = 0;
+
+static short rem[MAX_BITS]; // remaining scenes of each actor
+static uint64_t all = 0;        // set of all scenes
+static bool stopped = false;      // set once a stop request cut the search short
+static std::atomic<int> dual(0); // published by the solver, read by other threads
+static std::atomic<long long unsigned> explored(0);
+
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint64_t hash(uint64_t key)
+{
+  // splitmix64 finalizer
+  key ^= key >> 30; key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27; key *= 0x94d049bb133111ebULL;
+  return key ^ (key >> 31);
+}
+
+static dp_entry* lookup(uint64_t key)
+{
+  for(short i=0; i < PROBES; i++) {
+    dp_entry* e = &table[(hash(key) + i) & table_mask];
+    if(e->key == key) return e;
+    if(e->key == 0) return nullptr;
+  }
+  return nullptr;
+}
+
+// Stores a state. When all its slots are taken, replaces the one with fewest
+// remaining scenes, which is the cheapest to solve again
+static void store(uint64_t key, int value, bool exact)
+{
+  dp_entry* victim = nullptr;
+
+  for(short i=0; i < PROBES; i++) {
+    dp_entry* e = &table[(hash(key) + i) & table_mask];
+    if(e->key == key || e->key == 0) { victim = e; break; }
+    if(!victim || __builtin_popcountll(e->key) < __builtin_popcountll(victim->key)) victim = e;
+  }
+
+  victim->key = key;
+  victim->value = value;
+  victim->exact = exact;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sums the costs of a set of actors
+static inline int actors_cost(const word_t* actors)
+{
+  int cost = 0;
+  for(short w=0; w < scene_actors.words; w++) {
+    for(word_t b = actors[w]; b; b &= b - 1) cost += costs[w * WORD_BITS + __builtin_ctzll(b)];
+  }
+  return cost;
+}
+
+// Waiting cost of scheduling scene next, given the actors on location
+static inline int scene_cost(short scene, const word_t* on, int on_cost)
+{
+  word_t in[MAX_WORDS];
+  for(short w=0; w < scene_actors.words; w++) in[w] = on[w] & scene_actors[scene][w];
+  return on_cost - actors_cost(in);
+}
+
+// Updates started and pending actors when scene is scheduled, and undoes it
+static inline void schedule(short scene, word_t* started, word_t* pending)
+{
+  for(short w=0; w < scene_actors.words; w++) {
+    started[w] |= scene_actors[scene][w];
+    for(word_t b = scene_actors[scene][w]; b; b &= b - 1) {
+      short actor = w * WORD_BITS + __builtin_ctzll(b);
+      if(--rem[actor] == 0) bits_clear(pending, actor);
+    }
+  }
+}
+
+static inline void unschedule(short scene)
+{
+  for(short w=0; w < scene_actors.words; w++) {
+    for(word_t b = scene_actors[scene][w]; b; b &= b - 1) rem[w * WORD_BITS + __builtin_ctzll(b)]++;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Lower bound of the cost of the remaining scenes: actors on location wait in
+// the scenes they are not in until their last one (k3)
+static inline int state_bound(uint64_t remaining, const word_t* on)
+{
+  word_t comp[MAX_WORDS] = {remaining};
+  return bits_count(on, scene_actors.words) > 1 ? k3(comp, on) : 0;
+}
+
+// Publishes the lowest bound known while solving: the instance costs at least
+// as much as the cheapest of the states after the first scene, as nobody is
+// on location before it. Only the solver reads the table, so it calls this
+// every PUBLISH_EVERY states and other threads read dual
+static void publish_dual()
+{
+  int bound = INT_MAX;
+  for(short scene=0; scene < nscenes; scene++) {
+    uint64_t remaining = all & ~(uint64_t(1) << scene);
+    dp_entry* e = lookup(remaining);
+    if(e) {
+      bound = std::min(bound, e->value);
+      continue;
+    }
+
+    // Actors of the first scene which have other scenes are on location
+    word_t on[MAX_WORDS];
+    for(short w=0; w < scene_actors.words; w++) on[w] = scene_actors[scene][w];
+    for(short i=0; i < nactors; i++) if(wdays[i] < 2) bits_clear(on, i);
+    bound = std::min(bound, state_bound(remaining, on));
+  }
+  dual = bound;
+}
+
+// Returns the cost of scheduling the remaining scenes if it is smaller than
+// ub, or a lower bound of it not smaller than ub otherwise. started are the
+// actors of the scheduled scenes and pending the ones of the remaining scenes.
+// Once stop_requested is set it returns ub without storing anything, so the
+// table only keeps values that hold
+static int solve(uint64_t remaining, int ub, const word_t* started, const word_t* pending)
+{
+  if(remaining == 0) return 0;
+  if(stopped || stop_requested.load(std::memory_order_relaxed)) {
+    stopped = true;
+    return ub;
+  }
+
+  // Reuses the memoized value when it answers the question
+  int lb = 0;
+  dp_entry* e = lookup(remaining);
+  if(e) {
+    if(e->exact || e->value >= ub) return e->value;
+    lb = e->value;
+  }
+
+  // Actors on location
+  word_t on[MAX_WORDS];
+  for(short w=0; w < scene_actors.words; w++) on[w] = started[w] & pending[w];
+  int on_cost = actors_cost(on);
+
+  lb = std::max(lb, state_bound(remaining, on));
+  if(lb >= ub) {
+    store(remaining, lb, false);
+    return lb;
+  }
+
+  long long unsigned n = explored.load(std::memory_order_relaxed) + 1;
+  explored.store(n, std::memory_order_relaxed);
+  if(n % PUBLISH_EVERY == 0) publish_dual();
+
+  // Tries the cheapest scenes first
+  std::pair<int, short> children[64];
+  short nchildren = 0;
+  for(uint64_t b = remaining; b; b &= b - 1) {
+    short scene = __builtin_ctzll(b);
+    children[nchildren++] = std::make_pair(scene_cost(scene, on, on_cost), scene);
+  }
+  std::sort(children, children + nchildren);
+
+  int best = INT_MAX;
+  bool found = false;
+  for(short i=0; i < nchildren; i++) {
+    int cost = children[i].first;
+    short scene = children[i].second;
+
+    if(cost >= ub) { best = std::min(best, cost); continue; }
+
+    word_t cstarted[MAX_WORDS], cpending[MAX_WORDS];
+    std::copy(started, started + MAX_WORDS, cstarted);
+    std::copy(pending, pending + MAX_WORDS, cpending);
+
+    schedule(scene, cstarted, cpending);
+    int value = cost + solve(remaining & ~(uint64_t(1) << scene), ub - cost, cstarted, cpending);
+    unschedule(scene);
+    if(stopped) return ub;
+
+    // Later children only matter if they beat this one
+    if(value < ub) { ub = value; found = true; }
+    best = std::min(best, value);
+  }
+
+  store(remaining, best, found);
+  return best;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void dp_solve(size_t memory_mb)
+{
+  if(nscenes > 64) {
+    std::cerr << "Dynamic programming is limited to 64 scenes" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // Largest power of two number of entries that fits in the memory cap. Pages
+  // are only touched as states are stored
+  size_t entries = 1;
+  while(entries * 2 * sizeof(dp_entry) <= memory_mb << 20) entries *= 2;
+  free(table);
+  table = (dp_entry*)calloc(entries, sizeof(dp_entry));
+  if(!table) throw std::bad_alloc();
+  table_mask = entries - 1;
+  explored = 0;
+  stopped = false;
+
+  all = nscenes == 64 ? ~uint64_t(0) : (uint64_t(1) << nscenes) - 1;
+  word_t started[MAX_WORDS] = {0}, pending[MAX_WORDS] = {0};
+  for(short i=0; i < nactors; i++) {
+    rem[i] = wdays[i];
+    if(rem[i] > 0) bits_set(pending, i);
+  }
+
+  // Each improvement on the best solution is proved optimal or beaten by the
+  // next call, which always ends with the optimum found. A stopped search
+  // keeps the last bound published
+  publish_dual();
+  int value = solve(all, best_cost, started, pending);
+  if(stopped) return;
+  dual = std::min(value, best_cost.load());
+  if(value >= best_cost) return;
+
+  // Rebuilds the schedule by following the states whose costs add up
+  solution sol(nscenes);
+  uint64_t remaining = all;
+  for(short j=0; j < nscenes; j++) {
+    word_t on[MAX_WORDS];
+    for(short w=0; w < scene_actors.words; w++) on[w] = started[w] & pending[w];
+    int on_cost = actors_cost(on);
+
+    for(uint64_t b = remaining; b; b &= b - 1) {
+      short scene = __builtin_ctzll(b);
+      int cost = scene_cost(scene, on, on_cost);
+      if(cost > value) continue;
+
+      word_t cstarted[MAX_WORDS], cpending[MAX_WORDS];
+      std::copy(started, started + MAX_WORDS, cstarted);
+      std::copy(pending, pending + MAX_WORDS, cpending);
+      schedule(scene, cstarted, cpending);
+
+      uint64_t next = remaining & ~(uint64_t(1) << scene);
+      int rest = solve(next, value - cost + 1, cstarted, cpending);
+      if(stopped) return;
+      if(cost + rest == value) {
+        sol.sol[j] = scene;
+        value -= cost;
+        remaining = next;
+        std::copy(cstarted, cstarted + MAX_WORDS, started);
+        std::copy(cpending, cpending + MAX_WORDS, pending);
+        break;
+      }
+      unschedule(scene);
+    }
+  }
+
+  sol.comp.clear();
+  sol.lactive = sol.ractive = nscenes;
+  sol.lower_bound = dual;
+  update_solution(sol);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int dp_dual_bound()
+{
+  return dual;
+}
+
+long long unsigned dp_explored_nodes()
+{
+  return explored;
+}
+
+////////////////////////////////////////////////////////////////////////////////
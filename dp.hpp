@@ -0,0 +1,35 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: dp.hpp
+//
+//  @brief Exact solver by dynamic programming over the set of scheduled scenes.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DP_HPP
+#define DP_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// The cost of scheduling the remaining scenes only depends on the set of
+// scenes already scheduled, so states are memoized by that set. Each state is
+// solved by a bounded search which stores either its exact cost or a lower
+// bound, and uses k3 over the actors on location for pruning. At most
+// memory_mb megabytes are used for memoized states. Returns early once
+// stop_requested is set. Updates best_sol
+void dp_solve(size_t memory_mb);
+
+// Lowest bound known for the instance, as last published by the solver
+int dp_dual_bound();
+
+// Number of states expanded
+long long unsigned dp_explored_nodes();
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* DP_HPP */
+
+////////////////////////////////////////////////////////////////////////////////
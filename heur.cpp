@@ -2,23 +2,84 @@
 
 #include "common.hpp"
 #include "metaheuristic.hpp"
+#include "telemetry.hpp"
+#include "reduce.hpp"
+
+#include <getopt.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
 const float TIMEOUT = 30000; // Time in which the algorithm should finish
 
+////////////////////////////////////////////////////////////////////////////////
+// Prints command line usage and exits
+void usage(char *prog)
+{
+  std::cerr << "Usage: " << prog << " [options] <instance>" << std::endl;
+  std::cerr << "  -i, --islands N     number of populations evolving on their own threads (default 1)" << std::endl;
+  std::cerr << "  -s, --seed N        seed of the random numbers (default 0)" << std::endl;
+  std::cerr << "  -p, --population N  individuals on each population (default 25)" << std::endl;
+  std::cerr << "  -S, --selection S   parents selection: roulette, rank or tournament[:K] (default roulette, K 3)" << std::endl;
+  std::cerr << "  -l, --local MS      milliseconds of local search on each generation, 0 for none (default 0.5)" << std::endl;
+  std::cerr << "  -T, --telemetry F   writes progress as JSON lines to file F, - for stderr or fd:N" << std::endl;
+  std::cerr << "  -R, --report S      seconds between telemetry records (default 1)" << std::endl;
+  std::cerr << "  -r, --raw           solves the instance as read, without reducing it" << std::endl;
+  exit(EXIT_FAILURE);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Main function. Reads input and call other methods
 int main(int argc, char **argv)
 {
-  // Signal handling
-  signal(SIGINT, print_and_exit);
+  ga_params params;
+  const char* telemetry = nullptr;
+  bool reduce = true;
+  double report = 1;
+
+  // Reads options
+  static struct option options[] = {
+    {"islands", required_argument, 0, 'i'},
+    {"seed", required_argument, 0, 's'},
+    {"population", required_argument, 0, 'p'},
+    {"selection", required_argument, 0, 'S'},
+    {"local", required_argument, 0, 'l'},
+    {"telemetry", required_argument, 0, 'T'},
+    {"report", required_argument, 0, 'R'},
+    {"raw", no_argument, 0, 'r'},
+    {0, 0, 0, 0}
+  };
+  int opt;
+  while((opt = getopt_long(argc, argv, "i:s:p:S:l:T:R:r", options, nullptr)) != -1) {
+    switch(opt) {
+      case 'i': params.nislands = std::max(1, atoi(optarg)); break;
+      case 's': params.seed = strtoull(optarg, nullptr, 10); break;
+      case 'p': params.population = std::max(1, atoi(optarg)); break;
+      case 'S': if(!parse_selection(optarg, params)) usage(argv[0]); break;
+      case 'l': params.search_budget = std::max(0.0, atof(optarg)); break;
+      case 'T': telemetry = optarg; break;
+      case 'R': report = std::max(0.001, atof(optarg)); break;
+      case 'r': reduce = false; break;
+      default: usage(argv[0]);
+    }
+  }
+  if(optind >= argc) usage(argv[0]);
+
+  // Progress goes to its own stream, stdout only gets the result
+  if(telemetry && !telemetry_open(telemetry, report)) {
+    std::cerr << "Cannot open telemetry stream " << telemetry << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // Signal handling. The genetic algorithm is asked to stop and the result is
+  // printed once it returns
+  signal(SIGINT, request_stop);
 
   // Reads from input file
-  read_input(argv[1]);
+  read_input(argv[optind], reduce);
+  if(reduce) reduction_report();
 
   // Runs genetic algorithm until timeout
-  genetic_algorithm(TIMEOUT);
+  genetic_algorithm(TIMEOUT, params);
 
   // Prints and exit
   print_and_exit();
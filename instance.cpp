@@ -0,0 +1,333 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: instance.cpp
+//
+//  @brief Reading and writing of instance files.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "instance.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Binary files start with the magic, the version, the number of scenes and of
+// actors and a reserved field, all 16 bits. The costs follow as 32 bits
+// integers and then the rows of t as 64 bits words, little endian as on the
+// machines this runs on
+static const char MAGIC[4] = { 'S', 'O', 'P', 'B' };
+static const uint16_t VERSION = 1;
+
+struct binary_header
+{
+  char magic[4];
+  uint16_t version, nscenes, nactors, reserved;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Parser over a file mapped in memory
+class parser
+{
+public:
+  parser(const char* filename) : filename(filename), begin(nullptr), cur(nullptr), end(nullptr), size(0)
+  {
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) != 0) fail("can't be read");
+
+    size = st.st_size;
+    if(size == 0) fail("is empty");
+
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED) fail("can't be mapped");
+
+    begin = cur = (const char*)data;
+    end = begin + size;
+  }
+
+  ~parser() { if(begin) munmap((void*)begin, size); }
+
+  // Whole file, and the next character after more
+  inline const char* data() const { return begin; }
+  inline char peek() const { return *cur; }
+  inline size_t length() const { return size; }
+
+  // Skips white space, returns whether there is something left
+  inline bool more()
+  {
+    while(cur < end && isspace((unsigned char)*cur)) cur++;
+    return cur < end;
+  }
+
+  // Reads a non negative integer, which ends on white space or on stop
+  int integer(char stop=0)
+  {
+    if(!more() || !isdigit((unsigned char)*cur)) fail("has a missing or invalid number");
+
+    long value = 0;
+    while(cur < end && isdigit((unsigned char)*cur)) {
+      value = value * 10 + (*cur++ - '0');
+      if(value > INT_MAX) fail("has a number out of range");
+    }
+    if(cur < end && !isspace((unsigned char)*cur) && *cur != stop) fail("has a missing or invalid number");
+
+    return (int)value;
+  }
+
+  // Reads an integer in [min, max]
+  int integer(int min, int max, char stop=0)
+  {
+    int value = integer(stop);
+    if(value < min || value > max) fail("has a number out of range");
+    return value;
+  }
+
+  // Reads a word, which ends on white space, ';' or ':'
+  std::string word()
+  {
+    if(!more()) fail("ends too soon");
+
+    const char* start = cur;
+    if(*cur == ';') cur++;
+    else if(*cur == ':') cur += (cur + 1 < end && cur[1] == '=') ? 2 : 1;
+    else while(cur < end && !isspace((unsigned char)*cur) && *cur != ';' && *cur != ':') cur++;
+
+    return std::string(start, cur);
+  }
+
+  // Reads the word expected
+  void expect(const char* expected)
+  {
+    if(word() != expected) fail((std::string("misses '") + expected + "'").c_str());
+  }
+
+  void fail(const char* reason)
+  {
+    std::cerr << "Instance " << filename << " " << reason << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+private:
+  const char* filename;
+  const char *begin, *cur, *end;
+  size_t size;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Sizes the tables for an instance, checking its limits
+static void size_instance(parser& in, int scenes, int actors)
+{
+  if(scenes > MAX_BITS || actors > MAX_BITS) {
+    std::cerr << "Instances are limited to " << MAX_BITS << " scenes and actors" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if(scenes < 1 || actors < 1) in.fail("has no scenes or no actors");
+
+  nscenes = scenes;
+  nactors = actors;
+  t.resize(nactors, nscenes);
+  scene_actors.resize(nscenes, nactors);
+  costs.assign(nactors, 0);
+}
+
+// Marks actor i on scene j
+static inline void set_actor(short i, short j)
+{
+  t.set(i, j);
+  scene_actors.set(j, i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Text format: scenes, actors, the matrix by actor and the costs
+static void load_text(parser& in)
+{
+  int scenes = in.integer();
+  int actors = in.integer();
+  size_instance(in, scenes, actors);
+
+  for(short i=0; i < nactors; i++) {
+    for(short j=0; j < nscenes; j++) {
+      if(in.integer(0, 1)) set_actor(i, j);
+    }
+  }
+  for(short i=0; i < nactors; i++) costs[i] = in.integer(0, SHRT_MAX);
+
+  if(in.more()) in.fail("has data after the costs");
+}
+
+// MathProg data: the scalars n and m, the table T by actor and the costs c, in
+// that order, indexed from 1
+static void load_dat(parser& in)
+{
+  in.expect("data");
+  in.expect(";");
+
+  in.expect("param"); in.expect("n"); in.expect(":=");
+  int scenes = in.integer(';');
+  in.expect(";");
+  in.expect("param"); in.expect("m"); in.expect(":=");
+  int actors = in.integer(';');
+  in.expect(";");
+  size_instance(in, scenes, actors);
+
+  // Columns of T are scenes, given by their labels
+  std::vector<short> column(nscenes);
+  in.expect("param"); in.expect("T"); in.expect(":");
+  for(short j=0; j < nscenes; j++) column[j] = in.integer(1, nscenes, ':') - 1;
+  in.expect(":=");
+  for(short r=0; r < nactors; r++) {
+    short i = in.integer(1, nactors) - 1;
+    for(short j=0; j < nscenes; j++) {
+      if(in.integer(0, 1, ';')) set_actor(i, column[j]);
+    }
+  }
+  in.expect(";");
+
+  in.expect("param"); in.expect("c"); in.expect(":=");
+  for(short r=0; r < nactors; r++) {
+    short i = in.integer(1, nactors) - 1;
+    costs[i] = in.integer(0, SHRT_MAX, ';');
+  }
+  in.expect(";");
+  in.expect("end");
+  in.expect(";");
+}
+
+// Binary format: checks the header and the size, then copies the tables
+static void load_binary(parser& in)
+{
+  binary_header header;
+  if(in.length() < sizeof(header)) in.fail("has a truncated header");
+  memcpy(&header, in.data(), sizeof(header));
+  if(header.version != VERSION) in.fail("has an unknown binary version");
+
+  size_instance(in, header.nscenes, header.nactors);
+
+  size_t words = nwords(nscenes);
+  if(in.length() != sizeof(header) + nactors * sizeof(int32_t) + nactors * words * sizeof(word_t)) {
+    in.fail("has the wrong size for its header");
+  }
+
+  const char* data = in.data() + sizeof(header);
+  for(short i=0; i < nactors; i++) {
+    int32_t cost;
+    memcpy(&cost, data, sizeof(cost));
+    data += sizeof(cost);
+    if(cost < 0 || cost > SHRT_MAX) in.fail("has a cost out of range");
+    costs[i] = cost;
+  }
+
+  // Rows of t are copied whole, the transposed matrix is built from them
+  for(short i=0; i < nactors; i++) {
+    memcpy(t[i], data, words * sizeof(word_t));
+    data += words * sizeof(word_t);
+    if(nscenes % WORD_BITS && t[i][words - 1] >> (nscenes % WORD_BITS)) in.fail("has scenes out of range");
+
+    for(short w=0; w < (short)words; w++) {
+      for(word_t b = t[i][w]; b; b &= b - 1) scene_actors.set(w * WORD_BITS + __builtin_ctzll(b), i);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+instance_format load_instance(const char* filename)
+{
+  parser in(filename);
+
+  instance_format format = FORMAT_TEXT;
+  if(in.length() >= sizeof(MAGIC) && memcmp(in.data(), MAGIC, sizeof(MAGIC)) == 0) format = FORMAT_BINARY;
+  else if(in.more() && !isdigit((unsigned char)in.peek())) format = FORMAT_DAT;
+
+  switch(format) {
+    case FORMAT_TEXT: load_text(in); break;
+    case FORMAT_DAT: load_dat(in); break;
+    case FORMAT_BINARY: load_binary(in); break;
+  }
+
+  return format;
+}
+
+void save_instance(const char* filename, instance_format format)
+{
+  FILE* out = fopen(filename, "wb");
+  if(!out) {
+    std::cerr << "Can't write " << filename << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  if(format == FORMAT_BINARY) {
+    binary_header header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.nscenes = nscenes;
+    header.nactors = nactors;
+    header.reserved = 0;
+    fwrite(&header, sizeof(header), 1, out);
+
+    for(short i=0; i < nactors; i++) {
+      int32_t cost = costs[i];
+      fwrite(&cost, sizeof(cost), 1, out);
+    }
+    for(short i=0; i < nactors; i++) fwrite(t[i], sizeof(word_t), nwords(nscenes), out);
+  }
+  else if(format == FORMAT_DAT) {
+    fprintf(out, "data;\nparam n := %d;\nparam m := %d;\nparam T :", nscenes, nactors);
+    for(short j=0; j < nscenes; j++) fprintf(out, " %d", j + 1);
+    fprintf(out, " :=");
+    for(short i=0; i < nactors; i++) {
+      fprintf(out, "\n %d", i + 1);
+      for(short j=0; j < nscenes; j++) fprintf(out, " %d", (int)t.test(i, j));
+    }
+    fprintf(out, ";\nparam c :=");
+    for(short i=0; i < nactors; i++) fprintf(out, "\n %d %d", i + 1, costs[i]);
+    fprintf(out, ";\nend;\n");
+  }
+  else {
+    fprintf(out, "%d\n%d\n", nscenes, nactors);
+    for(short i=0; i < nactors; i++) {
+      for(short j=0; j < nscenes; j++) fprintf(out, j ? " %d" : "%d", (int)t.test(i, j));
+      fprintf(out, "\n");
+    }
+    for(short i=0; i < nactors; i++) fprintf(out, i ? " %d" : "%d", costs[i]);
+    fprintf(out, "\n");
+  }
+
+  if(ferror(out) | fclose(out)) {
+    std::cerr << "Can't write " << filename << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+uint64_t instance_fingerprint()
+{
+  // FNV-1a over the sizes, the costs and the rows of t
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](uint64_t value) {
+    for(short k=0; k < 8; k++, value >>= 8) hash = (hash ^ (value & 0xff)) * 1099511628211ull;
+  };
+
+  mix(nscenes);
+  mix(nactors);
+  for(short i=0; i < nactors; i++) mix(costs[i]);
+  for(short i=0; i < nactors; i++)
+    for(short w=0; w < t.words; w++) mix(t[i][w]);
+
+  return hash;
+}
+
+instance_format format_named(const char* name)
+{
+  const char* ext = strrchr(name, '.');
+  ext = ext ? ext + 1 : name;
+
+  if(strcmp(ext, "dat") == 0) return FORMAT_DAT;
+  if(strcmp(ext, "bin") == 0) return FORMAT_BINARY;
+  return FORMAT_TEXT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: instance.hpp
+//
+//  @brief Reading and writing of instance files.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INSTANCE_HPP
+#define INSTANCE_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Formats of instance files. Text is the format of the assignment: scenes,
+// actors, the matrix with one line per actor and the costs. Dat is the
+// MathProg data of pli.mod, as in exatos. Binary is a header followed by the
+// costs and the packed rows of t, as they are kept in memory
+enum instance_format { FORMAT_TEXT, FORMAT_DAT, FORMAT_BINARY };
+
+// Reads the instance on filename into nscenes, nactors, t, scene_actors and
+// costs, telling its format by the contents. The file is mapped in memory and
+// parsed in place. Exits with a message on malformed files
+instance_format load_instance(const char* filename);
+
+// Writes the instance loaded to filename in format. Exits with a message if
+// the file can't be written
+void save_instance(const char* filename, instance_format format);
+
+// Hash of the instance loaded, telling instances apart in files tied to one
+uint64_t instance_fingerprint();
+
+// Format named "text", "dat" or "bin", or the one of the extension of a file
+// name, text if unknown
+instance_format format_named(const char* name);
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* INSTANCE_HPP */
+
+////////////////////////////////////////////////////////////////////////////////
@@ -9,40 +9,114 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "metaheuristic.hpp"
+#include "moves.hpp"
+#include "telemetry.hpp"
 
 #include <chrono>
+#include <memory>
+#include <thread>
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Constants
-const short N_MEMBERS = 25; // Size of population (use odd numbers to crossover all but the fittest)
 const float MUTATION_RATE = 0.01f; // Probability of mutating a gene
 const float CROSSOVER_MIN_RATE = 0.5f; // Min percentage of genes to be crossed-over
 const float CROSSOVER_MAX_RATE = 0.8f; // Max percentage of genes to be crossed-over
+const int MIGRATION_INTERVAL = 50; // Generations between migrations among islands
+
+////////////////////////////////////////////////////////////////////////////////
+// Each island evolves its own population with its own random numbers and
+// parameters. Every MIGRATION_INTERVAL generations its fittest individual is
+// sent to the next island on a ring, where it replaces the worst one
+struct island
+{
+  prng rng; // Random numbers of the island
+  int size; // Individuals on the population (odd numbers crossover all but the fittest)
+  selection_t selection;
+  short tournament;
+  float mutation_rate, crossover_min_rate, crossover_max_rate;
+  float search_budget; // Milliseconds of local search per generation
+
+  move_eval eval; // Evaluator of the individual being changed
+  std::vector<short> position, child_1, child_2; // Crossover scratch buffers
+  std::vector<char> taken;
+  std::vector<double> prob; // Alias table of the parents selection
+  std::vector<int> alias, small, large;
+  std::vector<uint32_t> picks; // Contenders of a tournament
+  std::vector<solution> population, offspring; // Swapped every generation
+  solution spare; // Second child without room on an even size offspring
+  std::vector<int> order; // Local search order
+
+  // Individual received from the previous island
+  std::mutex lock;
+  solution migrant;
+  bool arrived = false;
+
+  // Random integer in [0, n) and real in [0, 1)
+  inline int randint(int n) { return rng.below(n); }
+  inline double random() { return rng.uniform(); }
+};
+
+static std::atomic<long long unsigned> generations(0); // over all islands
+
+// Background run, and the solution handed to it by ga_seed
+static std::thread background;
+static std::atomic<bool> running(false), halted(false);
+static std::mutex seed_lock;
+static solution seed;
+static bool seeded = false;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Auxiliary function to calculate the total cost of a solution
 int get_cost(solution& sol)
 {
-  int cost = 0;
-  // Calculates cost for each actor
+  const short words = scene_actors.words;
+  int first_day[MAX_BITS], last_day[MAX_BITS];
+  word_t seen[MAX_WORDS];
+  short working = 0, found;
+
+  // Actors that never work have an empty span and cost nothing
   for (short i = 0; i < nactors; i++) {
-    short first_day = 0, last_day = nscenes - 1;
-    // Finds first day of work
-    for (short j = 0; j < nscenes; j++) {
-      if (t[i][sol.sol[j]]) {
-        first_day = j;
-        break;
+    first_day[i] = 0;
+    last_day[i] = -1;
+    if (wdays[i] > 0) working++;
+  }
+
+  // Finds first day of work: the first scene in which the actor bit shows up
+  std::fill(seen, seen + words, 0);
+  found = 0;
+  for (short j = 0; j < nscenes && found < working; j++) {
+    const word_t* actors = scene_actors[sol.sol[j]];
+    for (short w = 0; w < words; w++) {
+      word_t fresh = actors[w] & ~seen[w];
+      seen[w] |= fresh;
+      for (; fresh; fresh &= fresh - 1, found++) {
+        first_day[w * WORD_BITS + __builtin_ctzll(fresh)] = j;
       }
     }
-    // Finds last day of work
-    for (short j = nscenes-1; j >= 0; j--) {
-      if (t[i][sol.sol[j]]) {
-        last_day = j;
-        break;
+  }
+
+  // Finds last day of work, scanning from the end
+  std::fill(seen, seen + words, 0);
+  found = 0;
+  for (short j = nscenes - 1; j >= 0 && found < working; j--) {
+    const word_t* actors = scene_actors[sol.sol[j]];
+    for (short w = 0; w < words; w++) {
+      word_t fresh = actors[w] & ~seen[w];
+      seen[w] |= fresh;
+      for (; fresh; fresh &= fresh - 1, found++) {
+        last_day[w * WORD_BITS + __builtin_ctzll(fresh)] = j;
       }
     }
-    // Sums actor cost to total
-    cost += (last_day - first_day + 1 - wdays[i]) * costs[i];
+  }
+
+  // Sums actors costs (plain reduction, vectorized by the compiler)
+  int cost = 0;
+  for (short i = 0; i < nactors; i++) {
+    cost += (last_day[i] - first_day[i] + 1 - wdays[i]) * costs[i];
   }
   return cost;
 }
@@ -51,23 +125,18 @@ int get_cost(solution& sol)
 // Completes solution sol with a greedy approach
 void greedy_solution(solution& sol)
 {
-  // List of pairs (scene, scene cost)
-  using scenes_t = std::pair<short, int>;
-  std::vector<scenes_t> scenes;
-  scenes.reserve(sol.comp.size());
-
-  // Gets only remaining scenes
+  // Marks remaining scenes
+  word_t remaining[MAX_WORDS] = {0};
   for (short scene: sol.comp) {
-    scenes.push_back(std::make_pair(scene, scene_costs[scene]));
+    bits_set(remaining, scene);
   }
 
-  // Sorts scenes in decreasing order of scene cost
-  std::sort(scenes.begin(), scenes.end(), [](const scenes_t& i, const scenes_t& j) { return i.second > j.second; });
-
-  // Completes solution
-  for (auto& scene: scenes) {
-    short idx = ++sol.lactive - 1;
-    sol.sol[idx] = scene.first;
+  // Completes solution with them in decreasing order of scene cost
+  for (short scene: greedy_order) {
+    if (bits_test(remaining, scene)) {
+      short idx = ++sol.lactive - 1;
+      sol.sol[idx] = scene;
+    }
   }
   sol.comp.clear();
 
@@ -77,7 +146,7 @@ void greedy_solution(solution& sol)
 
 ////////////////////////////////////////////////////////////////////////////////
 // Completes solution sol with a random approach
-void random_solution(solution& sol)
+void random_solution(solution& sol, prng& rng)
 {
   // List of scenes
   std::vector<short> scenes;
@@ -89,7 +158,9 @@ void random_solution(solution& sol)
   }
 
   // Random shuffle
-  std::random_shuffle(scenes.begin(), scenes.end());
+  for (short i = (short)scenes.size() - 1; i > 0; i--) {
+    std::swap(scenes[i], scenes[rng.below(i + 1)]);
+  }
 
   // Completes solution
   for (auto& scene: scenes) {
@@ -103,51 +174,113 @@ void random_solution(solution& sol)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Gets the fittest individual on a population
-solution get_fittest(std::vector<solution>& population, int& total_fitness)
+// Gets the index of the fittest individual on the population of an island, and
+// updates the best solution with it. Returns whether the best solution improved
+bool get_fittest(island& isl, int& fittest)
 {
-  int fittest_idx = 0;
-  total_fitness = 0;
+  std::vector<solution>& population = isl.population;
+  fittest = 0;
   // Search fittest individual of population
-  for (short i = 1; i < (short)population.size(); i++) {
-    if (population[i].lower_bound <= population[fittest_idx].lower_bound) {
-      fittest_idx = i;
+  for (int i = 1; i < (int)population.size(); i++) {
+    if (population[i].lower_bound <= population[fittest].lower_bound) {
+      fittest = i;
     }
-    total_fitness += population[i].lower_bound;
   }
   // Checks if fittest individual is also best solution
-  solution fittest = population[fittest_idx];
-  if (fittest.lower_bound < best_sol.lower_bound) {
-    best_sol = fittest;
+  return population[fittest].lower_bound < best_cost && update_solution(population[fittest]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Order crossover: the child keeps the genes of parent p on days min..max and
+// takes the others in the order they appear on parent q, starting after max
+void order_crossover(island& isl, const std::vector<short>& p, const std::vector<short>& q,
+    short min, short max, std::vector<short>& child)
+{
+  std::fill(isl.taken.begin(), isl.taken.end(), 0);
+  for (short k = min; k <= max; k++) {
+    child[k] = p[k];
+    isl.taken[p[k]] = 1;
+  }
+
+  short idx = (max + 1) % nscenes;
+  for (short k = 0; k < nscenes; k++) {
+    short scene = q[(max + 1 + k) % nscenes];
+    if (!isl.taken[scene]) {
+      child[idx] = scene;
+      idx = (idx + 1) % nscenes;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Partially mapped crossover: the child is parent q with the genes of parent p
+// on days min..max swapped into place
+void partially_mapped_crossover(island& isl, const std::vector<short>& p, const std::vector<short>& q,
+    short min, short max, std::vector<short>& child)
+{
+  std::copy(q.begin(), q.end(), child.begin());
+  for (short k = 0; k < nscenes; k++) {
+    isl.position[child[k]] = k;
+  }
+
+  for (short k = min; k <= max; k++) {
+    short j = isl.position[p[k]];
+    isl.position[child[k]] = j;
+    isl.position[p[k]] = k;
+    std::swap(child[k], child[j]);
   }
-  return fittest;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Performs one of the possible types of crossover on two "parents"
-void crossover(solution& individual_1, solution& individual_2)
+// Cycle crossover: positions are split in cycles of the permutation taking p
+// to q, and the children alternately inherit each cycle from p or q
+void cycle_crossover(island& isl, const std::vector<short>& p, const std::vector<short>& q,
+    std::vector<short>& child_1, std::vector<short>& child_2)
 {
-  // Chooses crossover type
-  short crossover_type = rand() % 3;
+  for (short k = 0; k < nscenes; k++) {
+    isl.position[p[k]] = k;
+  }
+
+  std::fill(isl.taken.begin(), isl.taken.end(), 0);
+  bool from_p = true;
+  for (short start = 0; start < nscenes; start++) {
+    if (isl.taken[start]) {
+      continue;
+    }
+    short k = start;
+    do {
+      isl.taken[k] = 1;
+      child_1[k] = from_p ? p[k] : q[k];
+      child_2[k] = from_p ? q[k] : p[k];
+      k = isl.position[q[k]];
+    } while (k != start);
+    from_p = !from_p;
+  }
+}
 
-  // Copies individual 1
-  solution temp_individual_1 = individual_1;
+////////////////////////////////////////////////////////////////////////////////
+// Performs one of the possible types of crossover on two "parents". Fitness is
+// updated by mutate, which is always applied to the children
+void crossover(island& isl, solution& individual_1, solution& individual_2)
+{
+  // Chooses crossover operator and where its range lies
+  short crossover_operator = isl.randint(3);
+  short crossover_type = isl.randint(3);
 
   // Crossover range
-  short min_range = (short)std::ceil(CROSSOVER_MIN_RATE * nscenes);
-  short max_range = (short)std::ceil(CROSSOVER_MAX_RATE * nscenes);
-  short range = min_range + rand() % (max_range - min_range + 1);
+  short min_range = (short)std::ceil(isl.crossover_min_rate * nscenes);
+  short max_range = (short)std::ceil(isl.crossover_max_rate * nscenes);
+  short range = min_range + isl.randint(max_range - min_range + 1);
   if (range == 0) {
     return;
   }
   else if (range == nscenes) {
-    individual_1 = individual_2;
-    individual_2 = temp_individual_1;
+    individual_1.sol.swap(individual_2.sol);
     return;
   }
 
   // Crossover indexes
-  short min, max, idx1, idx2;
+  short min, max;
   if (crossover_type <= 0) {
     // Does crossover at the beginning
     min = 0;
@@ -160,194 +293,597 @@ void crossover(solution& individual_1, solution& individual_2)
   }
   else {
     // Does crossover at the middle
-    min = (range == nscenes) ? 0 : rand() % (nscenes - range);
+    min = isl.randint(nscenes - range);
     max = min + (range - 1);
   }
 
-  // Keep individual 1 genes on crossover range
-  // and copies remaining genes from individual 2 on order
-  auto it_min = individual_1.sol.begin() + min;
-  auto it_max = individual_1.sol.begin() + max + 1;
-  idx2 = 0;
-  for (idx1 = 0; idx1 < nscenes - 1; idx1++) {
-    // Finds next gene not already present on new individual
-    while (std::find(it_min, it_max, individual_2.sol[idx2]) == it_max) {
-      idx2++;
+  // Children are built on the scratch buffers, which then take the place of
+  // the parents genes
+  const std::vector<short>& p = individual_1.sol;
+  const std::vector<short>& q = individual_2.sol;
+  if (crossover_operator <= 0) {
+    order_crossover(isl, p, q, min, max, isl.child_1);
+    order_crossover(isl, q, p, min, max, isl.child_2);
+  }
+  else if (crossover_operator <= 1) {
+    partially_mapped_crossover(isl, p, q, min, max, isl.child_1);
+    partially_mapped_crossover(isl, q, p, min, max, isl.child_2);
+  }
+  else {
+    cycle_crossover(isl, p, q, isl.child_1, isl.child_2);
+  }
+  individual_1.sol.swap(isl.child_1);
+  individual_2.sol.swap(isl.child_2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Performs one of the possible types of mutation on an individual
+void mutate(island& isl, solution& individual)
+{
+  move_eval& eval = isl.eval;
+
+  // Chooses mutation type
+  short mutation_type = isl.randint(3);
+
+  // Swaps are applied through the evaluator, which keeps the cost up to date
+  eval.load(individual);
+
+  // Tries mutating every scene by swapping. Each one mutates with probability
+  // mutation_rate, so instead of drawing for every scene the gap to the next
+  // mutated one is drawn
+  short idx2 = 0;
+  for (int idx1 = isl.rng.geometric(isl.mutation_rate); idx1 < nscenes - 1;
+       idx1 += 1 + isl.rng.geometric(isl.mutation_rate)) {
+    if (mutation_type <= 0) {
+      // Stops at half size
+      if (idx1 > nscenes / 2) {
+        break;
+      }
+      // Gets opposite gene
+      idx2 = nscenes - idx1 - 1;
     }
-    // Replaces genes outside crossover range
-    if (idx1 < min && idx1 > max) {
-      individual_1.sol[idx1] = individual_2.sol[idx2];
+    else if (mutation_type <= 1) {
+      // Gets neighbour gene
+      idx2 = idx1 + 1;
     }
+    else {
+      // Gets random gene after this one
+      idx2 = idx1 + 1 + isl.randint(nscenes - idx1 - 1);
+    }
+    // Swaps scenes
+    eval.swap(idx1, idx2);
   }
 
-  // Keep individual 2 genes on crossover range
-  // and copies remaining genes from individual 1 on order
-  it_min = individual_2.sol.begin() + min;
-  it_max = individual_2.sol.begin() + max + 1;
-  idx1 = 0;
-  for (idx2 = 0; idx2 < nscenes - 1; idx2++) {
-    // Finds next gene not already present on new individual
-    while (std::find(it_min, it_max, temp_individual_1.sol[idx1]) == it_max) {
-      idx1++;
-    }
-    // Replaces genes outside crossover range
-    if (idx2 < min && idx2 > max) {
-      individual_2.sol[idx2] = temp_individual_1.sol[idx1];
+  // Updates scenes order and fitness
+  eval.store(individual);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Builds the alias table of Vose from the weights on isl.prob, so individuals
+// are drawn with probability proportional to their weight in constant time
+void build_alias(island& isl)
+{
+  const int n = isl.population.size();
+  std::vector<double>& prob = isl.prob;
+
+  double total = 0;
+  for (int i = 0; i < n; i++) {
+    total += prob[i];
+  }
+
+  // Without weights every individual is as likely
+  if (total <= 0) {
+    std::fill(prob.begin(), prob.begin() + n, 1.0);
+    return;
+  }
+
+  // Splits scaled weights among those below and above the average
+  isl.small.clear();
+  isl.large.clear();
+  for (int i = 0; i < n; i++) {
+    prob[i] = prob[i] * n / total;
+    (prob[i] < 1 ? isl.small : isl.large).push_back(i);
+  }
+
+  // Each small weight is topped up by a large one, its alias
+  while (!isl.small.empty() && !isl.large.empty()) {
+    int s = isl.small.back(), l = isl.large.back();
+    isl.small.pop_back();
+    isl.alias[s] = l;
+    prob[l] += prob[s] - 1;
+    if (prob[l] < 1) {
+      isl.large.pop_back();
+      isl.small.push_back(l);
     }
   }
 
-  // Updates fitness
-  individual_1.lower_bound = get_cost(individual_1);
-  individual_2.lower_bound = get_cost(individual_2);
+  // Left overs are full up to rounding errors
+  for (int i: isl.small) {
+    prob[i] = 1;
+  }
+  for (int i: isl.large) {
+    prob[i] = 1;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Performs one of the possible types of mutation on an individual
-void mutate(solution& individual)
+// Prepares the parents selection for a generation
+void build_selection(island& isl)
 {
-  // Chooses mutation type
-  short mutation_type = rand() % 3;
+  const std::vector<solution>& population = isl.population;
+  const int n = population.size();
 
-  // Tries mutating every scene by swapping
-  short idx2 = 0;
-  for (short idx1 = 0; idx1 < nscenes - 1; idx1++) {
-    float mutation_chance = (double)rand() / (RAND_MAX);
-    if (mutation_chance < MUTATION_RATE) {
-      if (mutation_type <= 0) {
-        // Stops at half size
-        if (idx1 > nscenes / 2) {
-          break;
-        }
-        // Gets opposite gene
-        idx2 = nscenes - idx1 - 1;
-      }
-      else if (mutation_type <= 1) {
-        // Gets neighbour gene
-        idx2 = idx1 + 1;
-      }
-      else {
-        // Gets random gene after this one
-        idx2 = idx1 + 1 + rand() % (nscenes - idx1 - 1);
-      }
-      // Swaps scenes
-      short scene1 = individual.sol[idx1];
-      individual.sol[idx1] = individual.sol[idx2];
-      individual.sol[idx2] = scene1;
+  if (isl.selection == TOURNAMENT) {
+    return;
+  }
+
+  isl.prob.resize(n);
+  isl.alias.resize(n);
+
+  if (isl.selection == ROULETTE) {
+    // Chances decrease linearly with the share of the total cost
+    long total_fitness = 0;
+    for (int i = 0; i < n; i++) {
+      total_fitness += population[i].lower_bound;
+    }
+    for (int i = 0; i < n; i++) {
+      isl.prob[i] = total_fitness - population[i].lower_bound;
+    }
+  }
+  else {
+    // Chances decrease linearly with the rank, the fittest having n times the
+    // chances of the worst. The alias table holds the ranking until it is built
+    for (int i = 0; i < n; i++) {
+      isl.alias[i] = i;
+    }
+    std::sort(isl.alias.begin(), isl.alias.end(), [&population](int i, int j) {
+      return population[i].lower_bound < population[j].lower_bound;
+    });
+    for (int r = 0; r < n; r++) {
+      isl.prob[isl.alias[r]] = n - r;
     }
   }
 
-  // Updates fitness
-  individual.lower_bound = get_cost(individual);
+  build_alias(isl);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Chooses on individual by the roulette method
-int roulette(std::vector<solution>& population, int total_fitness)
+// Chooses a parent with the selection strategy of the island
+int select_parent(island& isl)
 {
-  // Randomizes roulette range
-  float random_probability = (double)rand() / (RAND_MAX);
-  // Searches for individual on this range
-  float current_probability = 0;
-  for (short i = 0; i < N_MEMBERS; i++) {
-    float fitness_ratio = population[i].lower_bound / (float)total_fitness;
-    current_probability += (1 - fitness_ratio) / (N_MEMBERS - 1);
-    if (current_probability >= random_probability) {
-      return i;
+  const int n = isl.population.size();
+
+  if (isl.selection == TOURNAMENT) {
+    // Fittest among some random individuals, drawn all at once
+    isl.rng.below(n, isl.picks.data(), isl.tournament);
+    int winner = isl.picks[0];
+    for (short k = 1; k < isl.tournament; k++) {
+      int i = isl.picks[k];
+      if (isl.population[i].lower_bound < isl.population[winner].lower_bound) {
+        winner = i;
+      }
     }
+    return winner;
   }
-  // Should not reach this point
-  return rand() % N_MEMBERS;
+
+  // Draws a column of the alias table, and the individual or its alias
+  int i = isl.randint(n);
+  return isl.random() < isl.prob[i] ? i : isl.alias[i];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Evolves a population to the next generation
-void evolve_population(std::vector<solution>& population, int total_fitness)
+// Evolves the population of an island to the next generation, keeping its
+// fittest individual. Children are built in place on the offspring buffer,
+// whose individuals already hold room for their genes
+void evolve_population(island& isl, int fittest)
 {
-  // Creates new population
-  std::vector<solution> new_population;
-  new_population.reserve(N_MEMBERS);
+  const std::vector<solution>& population = isl.population;
+  std::vector<solution>& offspring = isl.offspring;
 
   // Saves fittest individual
-  solution fittest = get_fittest(population, total_fitness);
-  new_population.push_back(fittest);
+  offspring[0] = population[fittest];
 
   // Generates new individuals
-  for (short i = 1; i < N_MEMBERS; i = i + 2) {
-    // Gets parents and creates children
-    short parent_idx1 = roulette(population, total_fitness);
-    short parent_idx2 = roulette(population, total_fitness);
+  build_selection(isl);
+  for (int i = 1; i < isl.size; i = i + 2) {
+    bool room = i + 1 < isl.size;
 
-    solution child_1 = population[parent_idx1];
-    solution child_2 = population[parent_idx2];
+    // Gets parents and creates children
+    solution& child_1 = offspring[i];
+    solution& child_2 = room ? offspring[i + 1] : isl.spare;
+    child_1 = population[select_parent(isl)];
+    child_2 = population[select_parent(isl)];
 
     // Crossovers parents genes
-    crossover(child_1, child_2);
+    crossover(isl, child_1, child_2);
 
     // Mutates children
-    mutate(child_1);
-    mutate(child_2);
+    mutate(isl, child_1);
+    if (room) {
+      mutate(isl, child_2);
+    }
+  }
+
+  // Offspring become the population
+  isl.population.swap(offspring);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Improves an individual with first improvement insertion, swap and block
+// reversal moves, until none improves it or the deadline passes. Returns
+// whether it reached a local optimum
+bool local_search(island& isl, solution& individual, std::chrono::steady_clock::time_point deadline)
+{
+  move_eval& eval = isl.eval;
+  eval.load(individual);
+
+  bool improved = true;
+  while (improved) {
+    improved = false;
+    for (short i = 0; i < nscenes; i++) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        eval.store(individual);
+        return false;
+      }
 
-    // Saves children to new population
-    new_population.push_back(child_1);
-    new_population.push_back(child_2);
+      // Moves scene at i to any other day
+      for (short k = 0; k < nscenes; k++) {
+        if (k != i && eval.insert_delta(i, k) < 0) {
+          eval.insert(i, k);
+          improved = true;
+        }
+      }
+
+      // Swaps it with, or reverses the block up to, a later day
+      for (short j = i + 1; j < nscenes; j++) {
+        if (eval.swap_delta(i, j) < 0) {
+          eval.swap(i, j);
+          improved = true;
+        }
+        if (j > i + 1 && eval.reverse_delta(i, j) < 0) {
+          eval.reverse(i, j);
+          improved = true;
+        }
+      }
+    }
   }
 
-  // Updates population
-  population = new_population;
+  eval.store(individual);
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Performs genetic algorithm meta heuristics
-void genetic_algorithm(float time_max)
+// Spends the search budget of an island improving its new individuals, the
+// fittest ones first
+void improve_population(island& isl)
+{
+  auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::microseconds((long)(isl.search_budget * 1000));
+
+  std::vector<int>& order = isl.order;
+  order.resize(isl.size - 1);
+  for (int i = 1; i < isl.size; i++) {
+    order[i - 1] = i;
+  }
+  std::sort(order.begin(), order.end(), [&isl](int i, int j) {
+    return isl.population[i].lower_bound < isl.population[j].lower_bound;
+  });
+
+  for (int i: order) {
+    if (!local_search(isl, isl.population[i], deadline)) {
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replaces the worst individual of an island with the one received, if any
+void receive_migrant(island& isl)
+{
+  std::lock_guard<std::mutex> guard(isl.lock);
+  if (!isl.arrived) {
+    return;
+  }
+
+  auto worst = std::max_element(isl.population.begin(), isl.population.end(),
+      [](const solution& i, const solution& j) { return i.lower_bound < j.lower_bound; });
+  *worst = isl.migrant;
+  isl.arrived = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sends an individual to an island, replacing any not yet received
+void send_migrant(island& isl, const solution& individual)
+{
+  std::lock_guard<std::mutex> guard(isl.lock);
+  isl.migrant = individual;
+  isl.arrived = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replaces the worst individual of an island with the seed, if any
+void receive_seed(island& isl)
+{
+  std::lock_guard<std::mutex> guard(seed_lock);
+  if (!seeded) {
+    return;
+  }
+
+  auto worst = std::max_element(isl.population.begin(), isl.population.end(),
+      [](const solution& i, const solution& j) { return i.lower_bound < j.lower_bound; });
+  *worst = seed;
+  seeded = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sizes the buffers of an island once, generations reuse them
+void size_buffers(island& isl)
 {
-  // Creates population
-  std::vector<solution> population;
-  population.reserve(N_MEMBERS);
+  isl.population.reserve(isl.size);
+  isl.offspring.assign(isl.size, solution(nscenes));
+  isl.spare = solution(nscenes);
+  isl.order.reserve(isl.size);
+  isl.small.reserve(isl.size);
+  isl.large.reserve(isl.size);
+  isl.picks.resize(std::max<short>(1, isl.tournament));
+  isl.position.resize(nscenes);
+  isl.child_1.resize(nscenes);
+  isl.child_2.resize(nscenes);
+  isl.taken.resize(nscenes);
+}
 
+////////////////////////////////////////////////////////////////////////////////
+// Fills the population of an island with the greedy solution and random ones.
+// Returns the index of the fittest individual
+int populate(island& isl)
+{
   // Runs greedy algorithm for initial best solution
-  best_sol = solution(nscenes);
-  greedy_solution(best_sol);
-  population.push_back(best_sol);
+  solution greedy(nscenes);
+  greedy_solution(greedy);
+  update_solution(greedy);
+  isl.population.push_back(greedy);
 
   // Randomizes individuals
-  for (short i = 1; i < N_MEMBERS; i++) {
+  for (int i = 1; i < isl.size; i++) {
     solution new_sol(nscenes);
-    random_solution(new_sol);
-    population.push_back(new_sol);
+    random_solution(new_sol, isl.rng);
+    isl.population.push_back(new_sol);
   }
 
   // Updates best solution
-  int total_fitness = 0;
-  solution fittest = get_fittest(population, total_fitness);
-  std::cout << "Generation 0 -> Fittest: " << fittest.lower_bound << std::endl;
+  int fittest;
+  get_fittest(isl, fittest);
+  return fittest;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Evolves island self by one generation, and sends its fittest individual to
+// the next island on the ring every MIGRATION_INTERVAL generations
+void evolve_island(island* islands, short nislands, short self, int generation, int& fittest)
+{
+  island& isl = islands[self];
+
+  generations.fetch_add(1, std::memory_order_relaxed);
+  evolve_population(isl, fittest);
+  if (isl.search_budget > 0) {
+    improve_population(isl);
+  }
+  if (nislands > 1) {
+    receive_migrant(isl);
+  }
+  if (self == 0 && running.load(std::memory_order_relaxed)) {
+    receive_seed(isl);
+  }
+
+  // Gets fittest solution, improvements of the best one are reported by the
+  // telemetry
+  get_fittest(isl, fittest);
+
+  // Sends fittest to the next island
+  if (nislands > 1 && generation % MIGRATION_INTERVAL == 0) {
+    send_migrant(islands[(self + 1) % nislands], isl.population[fittest]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Evolves island self until timeout, migrating to the next one on the ring
+void run_island(island* islands, short nislands, short self, float time_max)
+{
+  size_buffers(islands[self]);
+  int fittest = populate(islands[self]);
 
   // Timer initialization
   auto time_start = std::chrono::high_resolution_clock::now();
   auto time_now = std::chrono::high_resolution_clock::now();
   std::chrono::duration<float, std::milli> time_delta = time_start - time_now;
 
-  // Runs until timeout
+  // Runs until timeout, or until a stop is requested
   int generation = 0;
-  while (time_delta.count() < time_max) {
+  while (time_delta.count() < time_max && !stop_requested.load(std::memory_order_relaxed) &&
+         !halted.load(std::memory_order_relaxed)) {
     // Evolves population
     generation++;
-    evolve_population(population, total_fitness);
-
-    // Gets fittest solution and total fitness
-    solution new_fittest = get_fittest(population, total_fitness);
+    evolve_island(islands, nislands, self, generation, fittest);
 
     // Updates elapsed time
     time_now = std::chrono::high_resolution_clock::now();
     time_delta = time_now - time_start;
+  }
+}
 
-    // Prints generation results
-    if (new_fittest.lower_bound < fittest.lower_bound || time_delta.count() >= time_max) {
-      fittest = new_fittest;
-      std::cout << "Generation " << generation;
-      std::cout << " -> Fittest: " << fittest.lower_bound;
-      std::cout << " / Time: " << time_delta.count() / 1000 << std::endl;
+////////////////////////////////////////////////////////////////////////////////
+// Reads a selection strategy by name
+bool parse_selection(const char* name, ga_params& params)
+{
+  if (strcmp(name, "roulette") == 0) {
+    params.selection = ROULETTE;
+  }
+  else if (strcmp(name, "rank") == 0) {
+    params.selection = RANK;
+  }
+  else if (strncmp(name, "tournament", 10) == 0 && (name[10] == 0 || name[10] == ':')) {
+    params.selection = TOURNAMENT;
+    if (name[10] == ':') {
+      params.tournament = std::max(1, atoi(name + 11));
     }
   }
+  else {
+    return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Performs genetic algorithm meta heuristics
+void genetic_algorithm(float time_max, const ga_params& params)
+{
+  const short nislands = params.nislands;
+  std::unique_ptr<island[]> islands(new island[nislands]);
+
+  // The first island keeps the default parameters, the others mutate more.
+  // Random numbers of each island follow those of the previous one
+  for (short i = 0; i < nislands; i++) {
+    islands[i].rng = i > 0 ? islands[i - 1].rng : prng(params.seed);
+    if (i > 0) {
+      islands[i].rng.jump();
+    }
+    islands[i].size = params.population;
+    islands[i].selection = params.selection;
+    islands[i].tournament = params.tournament;
+    islands[i].mutation_rate = MUTATION_RATE * (1 << (i % 3));
+    islands[i].crossover_min_rate = CROSSOVER_MIN_RATE;
+    islands[i].crossover_max_rate = CROSSOVER_MAX_RATE;
+    islands[i].search_budget = params.search_budget;
+    islands[i].migrant = solution(nscenes);
+  }
+
+  // Islands other than the first run on their own threads
+  std::vector<std::thread> threads;
+  for (short i = 1; i < nislands; i++) {
+    threads.push_back(std::thread(run_island, islands.get(), nislands, i, time_max));
+  }
+  run_island(islands.get(), nislands, 0, time_max);
+
+  for (auto& thread: threads) {
+    thread.join();
+  }
+  telemetry_event("ga_done");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Runs the genetic algorithm on a background thread. Threads of the islands
+// inherit its priority
+void ga_start(const ga_params& params)
+{
+  halted = false;
+  running = true;
+  background = std::thread([params]() {
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), 19);
+    genetic_algorithm(std::numeric_limits<float>::infinity(), params);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stops the background genetic algorithm
+void ga_stop()
+{
+  if (!background.joinable()) {
+    return;
+  }
+
+  halted = true;
+  background.join();
+  running = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether the background genetic algorithm is running
+bool ga_running()
+{
+  return running.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Hands a solution to the background genetic algorithm
+void ga_seed(const solution& sol)
+{
+  std::lock_guard<std::mutex> guard(seed_lock);
+  seed = sol;
+  seeded = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Times count crossovers, or mutations, of random individuals
+double time_ga_kernel(bool mutation, int count, const ga_params& params)
+{
+  island isl;
+  isl.rng = prng(params.seed);
+  isl.size = std::max(2, params.population);
+  isl.selection = params.selection;
+  isl.tournament = params.tournament;
+  isl.mutation_rate = MUTATION_RATE;
+  isl.crossover_min_rate = CROSSOVER_MIN_RATE;
+  isl.crossover_max_rate = CROSSOVER_MAX_RATE;
+  size_buffers(isl);
+
+  for (int i = 0; i < isl.size; i++) {
+    solution individual(nscenes);
+    random_solution(individual, isl.rng);
+    isl.population.push_back(individual);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (int k = 0; k < count; k++) {
+    solution& a = isl.population[k % isl.size];
+    if (mutation) {
+      mutate(isl, a);
+    }
+    else {
+      crossover(isl, a, isl.population[(k + 1) % isl.size]);
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return elapsed.count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Times count generations of a single island, after warmup ones
+double time_ga_generations(int warmup, int count, const ga_params& params, void (*warm)())
+{
+  island isl;
+  isl.rng = prng(params.seed);
+  isl.size = std::max(2, params.population);
+  isl.selection = params.selection;
+  isl.tournament = params.tournament;
+  isl.mutation_rate = MUTATION_RATE;
+  isl.crossover_min_rate = CROSSOVER_MIN_RATE;
+  isl.crossover_max_rate = CROSSOVER_MAX_RATE;
+  isl.search_budget = params.search_budget;
+  size_buffers(isl);
+
+  int fittest = populate(isl);
+  for (int g = 1; g <= warmup; g++) {
+    evolve_island(&isl, 1, 0, g, fittest);
+  }
+  if (warm) {
+    warm();
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (int g = warmup + 1; g <= warmup + count; g++) {
+    evolve_island(&isl, 1, 0, g, fittest);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return elapsed.count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Number of generations evolved so far over all islands
+long long unsigned ga_generations()
+{
+  return generations.load(std::memory_order_relaxed);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -15,15 +15,67 @@
 
 #include "common.hpp"
 
+#include "prng.hpp"
+
 ////////////////////////////////////////////////////////////////////////////////
+// Cost of the complete solution sol
+int get_cost(solution& sol);
+
 // Completes solution sol with a greedy approach
 void greedy_solution(solution& sol);
 
 // Completes solution sol with a random approach
-void random_solution(solution& sol);
+void random_solution(solution& sol, prng& rng);
+
+// Parent selection strategies: roulette wheel on the cost, k-tournament, and
+// linear ranking
+enum selection_t { ROULETTE, TOURNAMENT, RANK };
+
+// Parameters of the genetic algorithm
+struct ga_params
+{
+  short nislands = 1;               // populations evolving on their own threads
+  int population = 25;              // individuals on each population
+  selection_t selection = ROULETTE; // how parents are chosen
+  short tournament = 3;             // individuals on each tournament
+  uint64_t seed = 0;                // seed of the random numbers
+  float search_budget = 0.5f;       // milliseconds of local search per generation, 0 for none
+};
+
+// Reads a selection strategy named "roulette", "rank" or "tournament[:K]".
+// Returns false if the name is not valid
+bool parse_selection(const char* name, ga_params& params);
+
+// Performs genetic algorithm meta heuristics for time_max milliseconds, or until
+// stop_requested is set
+void genetic_algorithm(float time_max, const ga_params& params = ga_params());
+
+// Runs the genetic algorithm of params on a background thread until ga_stop,
+// with the lowest scheduling priority so it only takes idle cores. Improvements
+// go to best_sol as they are found
+void ga_start(const ga_params& params = ga_params());
+
+// Stops the background genetic algorithm and waits for it
+void ga_stop();
+
+// Whether the background genetic algorithm is running
+bool ga_running();
+
+// Hands a complete solution to the background genetic algorithm, which takes
+// it in place of its worst individual on the next generation. A solution not
+// yet taken is replaced
+void ga_seed(const solution& sol);
+
+// Number of generations evolved so far over all islands
+long long unsigned ga_generations();
+
+// Times count crossovers (mutations if mutation is set) of random individuals
+// of a population of params, for the benchmarks. Returns the seconds taken
+double time_ga_kernel(bool mutation, int count, const ga_params& params = ga_params());
 
-// Performs genetic algorithm meta heuristics
-void genetic_algorithm(float time_max);
+// Times count generations of a single island of params, after warmup ones. The
+// function warm, if given, is called between both. Returns the seconds taken
+double time_ga_generations(int warmup, int count, const ga_params& params, void (*warm)() = nullptr);
 
 ////////////////////////////////////////////////////////////////////////////////
 
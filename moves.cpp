@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: moves.cpp
+//
+//  @brief Incremental evaluation of moves on a complete solution.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "moves.hpp"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+
+void move_eval::load(const solution& sol)
+{
+  for(short j=0; j < nscenes; j++) order[j] = sol.sol[j];
+
+  rebuild();
+}
+
+void move_eval::store(solution& sol) const
+{
+  for(short j=0; j < nscenes; j++) sol.sol[j] = order[j];
+  sol.lower_bound = total;
+}
+
+void move_eval::rebuild()
+{
+  const short words = scene_actors.words;
+  word_t seen[MAX_WORDS];
+  short working = 0, found;
+
+  // Actors that never work have an empty span and cost nothing
+  for(short i=0; i < nactors; i++) {
+    first[i] = last[i] = -1;
+    if(wdays[i] > 0) working++;
+  }
+
+  // First and last working days: the first scene in which the actor bit shows
+  // up, scanning from each end
+  std::fill(seen, seen + words, 0);
+  found = 0;
+  for(short j=0; j < nscenes && found < working; j++) {
+    const word_t* actors = scene_actors[order[j]];
+    for(short w=0; w < words; w++) {
+      word_t fresh = actors[w] & ~seen[w];
+      seen[w] |= fresh;
+      for(; fresh; fresh &= fresh - 1, found++) first[w * WORD_BITS + __builtin_ctzll(fresh)] = j;
+    }
+  }
+
+  std::fill(seen, seen + words, 0);
+  found = 0;
+  for(short j=nscenes-1; j >= 0 && found < working; j--) {
+    const word_t* actors = scene_actors[order[j]];
+    for(short w=0; w < words; w++) {
+      word_t fresh = actors[w] & ~seen[w];
+      seen[w] |= fresh;
+      for(; fresh; fresh &= fresh - 1, found++) last[w * WORD_BITS + __builtin_ctzll(fresh)] = j;
+    }
+  }
+
+  total = 0;
+  for(short i=0; i < nactors; i++) total += actor_cost(i, first[i], last[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+short move_eval::next_day(short i, short j) const
+{
+  for(; j <= last[i]; j++)
+    if(works(i, j)) return j;
+  return -1;
+}
+
+short move_eval::prev_day(short i, short j) const
+{
+  for(; j >= first[i]; j--)
+    if(works(i, j)) return j;
+  return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int move_eval::swap_delta(short i, short j) const
+{
+  int delta = 0;
+
+  // Only actors in exactly one of the two scenes change their working days
+  const word_t *a = scene_actors[order[i]], *b = scene_actors[order[j]];
+  for(short w=0; w < scene_actors.words; w++) {
+    for(word_t x = a[w] ^ b[w]; x; x &= x - 1) {
+      short actor = w * WORD_BITS + __builtin_ctzll(x);
+      short from = (a[w] & (x & -x)) ? i : j; // day the actor leaves
+      short to = from == i ? j : i;           // day the actor moves to
+
+      // Span of the other working days
+      short f = first[actor], l = last[actor];
+      if(f == from) f = next_day(actor, from + 1);
+      if(l == from) l = prev_day(actor, from - 1);
+
+      short nf = (f == -1) ? to : std::min(f, to);
+      short nl = (l == -1) ? to : std::max(l, to);
+
+      delta += actor_cost(actor, nf, nl) - actor_cost(actor, first[actor], last[actor]);
+    }
+  }
+
+  return delta;
+}
+
+int move_eval::insert_delta(short i, short k) const
+{
+  if(i == k) return 0;
+
+  int delta = 0;
+  const word_t* moved = scene_actors[order[i]];
+
+  // Days between i and k shift one day towards i
+  short lo = std::min(i, k), hi = std::max(i, k), shift = i < k ? -1 : 1;
+
+  for(short actor=0; actor < nactors; actor++) {
+    short f = first[actor], l = last[actor];
+    if(f == -1) continue;
+
+    bool in = bits_test(moved, actor);
+
+    // Span of the other working days
+    if(in) {
+      if(f == i) f = next_day(actor, i + 1);
+      if(l == i) l = prev_day(actor, i - 1);
+    }
+
+    // Shifting keeps the order of the other days
+    if(f != -1 && f >= lo && f <= hi) f += shift;
+    if(l != -1 && l >= lo && l <= hi) l += shift;
+
+    if(in) {
+      f = (f == -1) ? k : std::min(f, k);
+      l = (l == -1) ? k : std::max(l, k);
+    }
+
+    delta += actor_cost(actor, f, l) - actor_cost(actor, first[actor], last[actor]);
+  }
+
+  return delta;
+}
+
+int move_eval::reverse_delta(short i, short j) const
+{
+  int delta = 0;
+
+  for(short actor=0; actor < nactors; actor++) {
+    short f = first[actor], l = last[actor];
+
+    // Spans apart from the block or covering it keep their ends
+    if(f == -1 || l < i || f > j || (f < i && l > j)) continue;
+
+    // Ends inside the block come from its other side, mirrored
+    short nf = f, nl = l;
+    if(f >= i) nf = i + j - prev_day(actor, std::min(l, j));
+    if(l <= j) nl = i + j - next_day(actor, std::max(f, i));
+
+    delta += actor_cost(actor, nf, nl) - actor_cost(actor, f, l);
+  }
+
+  return delta;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void move_eval::swap(short i, short j)
+{
+  if(i == j) return;
+
+  const word_t *a = scene_actors[order[i]], *b = scene_actors[order[j]];
+  for(short w=0; w < scene_actors.words; w++) {
+    for(word_t x = a[w] ^ b[w]; x; x &= x - 1) {
+      short actor = w * WORD_BITS + __builtin_ctzll(x);
+      short from = (a[w] & (x & -x)) ? i : j;
+      short to = from == i ? j : i;
+
+      // The actor works on exactly one of the days, moves its span with it
+      short f = first[actor], l = last[actor];
+      if(f == from) f = next_day(actor, from + 1);
+      if(l == from) l = prev_day(actor, from - 1);
+
+      total -= actor_cost(actor, first[actor], last[actor]);
+      first[actor] = (f == -1) ? to : std::min(f, to);
+      last[actor] = (l == -1) ? to : std::max(l, to);
+      total += actor_cost(actor, first[actor], last[actor]);
+    }
+  }
+
+  std::swap(order[i], order[j]);
+}
+
+void move_eval::insert(short i, short k)
+{
+  if(i == k) return;
+
+  short scene = order[i];
+  if(i < k) std::copy(order + i + 1, order + k + 1, order + i);
+  else std::copy_backward(order + k, order + i, order + i + 1);
+  order[k] = scene;
+
+  rebuild();
+}
+
+void move_eval::reverse(short i, short j)
+{
+  std::reverse(order + i, order + j + 1);
+
+  rebuild();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: moves.hpp
+//
+//  @brief Incremental evaluation of moves on a complete solution.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MOVES_HPP
+#define MOVES_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Keeps, for each actor, its first and last working days in a scenes order.
+// The cost change of swapping two days or moving a scene to another day is
+// computed from them by touching only the actors whose span can change,
+// without changing the order
+class move_eval
+{
+public:
+  // Loads the scenes order of a complete solution
+  void load(const solution& sol);
+
+  // Writes the current order and its cost to sol
+  void store(solution& sol) const;
+
+  // Cost of the current order
+  inline int cost() const { return total; }
+
+  // Scene at day j
+  inline short operator[](short j) const { return order[j]; }
+
+  // Cost change of swapping the scenes at days i and j
+  int swap_delta(short i, short j) const;
+
+  // Cost change of moving the scene at day i to day k, shifting the ones between
+  int insert_delta(short i, short k) const;
+
+  // Cost change of reversing the scenes from day i to day j, with i < j
+  int reverse_delta(short i, short j) const;
+
+  // Applies the moves
+  void swap(short i, short j);
+  void insert(short i, short k);
+  void reverse(short i, short j);
+
+private:
+  short order[MAX_BITS];                 // scene at each day
+  short first[MAX_BITS], last[MAX_BITS]; // first and last working days of each actor
+  int total;                             // cost of the order
+
+  // Cost of actor i with the given span
+  inline int actor_cost(short i, short f, short l) const { return f == -1 ? 0 : (l - f + 1 - wdays[i]) * costs[i]; }
+
+  // Whether actor i works on day j
+  inline bool works(short i, short j) const { return t.test(i, order[j]); }
+
+  // First working day of actor i from day j on, and last one up to day j
+  short next_day(short i, short j) const;
+  short prev_day(short i, short j) const;
+
+  // Recomputes the spans and cost of the order
+  void rebuild();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* MOVES_HPP */
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: node.cpp
+//
+//  @brief Compact nodes of the branch and bound tree, the pool they are
+//  allocated from and the queue of open nodes.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "node.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+short node::scenes = 0;
+short node::words = 0;
+size_t node::bytes = 0;
+
+void node::setup(short nscenes)
+{
+  if(nscenes > UINT8_MAX) {
+    std::cerr << "Branch and bound is limited to " << UINT8_MAX << " scenes" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  scenes = nscenes;
+  words = nwords(nscenes);
+
+  // Rounds to whole words so every node in a chunk stays aligned
+  bytes = sizeof(node) + words * sizeof(word_t) + scenes;
+  bytes = (bytes + sizeof(word_t) - 1) / sizeof(word_t) * sizeof(word_t);
+}
+
+void node::root()
+{
+  lower_bound = 0;
+  lactive = 0;
+  ractive = scenes;
+
+  std::fill(comp(), comp() + words, 0);
+  for(short i=0; i < scenes; i++) bits_set(comp(), i);
+}
+
+void node::to_solution(solution& out) const
+{
+  out.lactive = lactive;
+  out.ractive = ractive;
+  out.lower_bound = lower_bound;
+
+  out.sol.assign(scenes, -1);
+  for(short j=0; j < lactive; j++) out.sol[j] = sol()[j];
+  for(short j=ractive; j < scenes; j++) out.sol[j] = sol()[j];
+
+  out.comp.clear();
+  for(short i=0; i < scenes; i++) if(bits_test(comp(), i)) out.comp.push_back(i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+node_pool::~node_pool()
+{
+  for(char* chunk: chunks) free(chunk);
+}
+
+node* node_pool::alloc()
+{
+  node* n;
+
+  nodes.store(nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+  // Reuses released nodes first
+  if(free_list) {
+    n = free_list;
+    free_list = *(node**)n;
+    return n;
+  }
+
+  // Takes a new chunk when the current one is exhausted
+  if((size_t)(end - cur) < node::size()) {
+    cur = (char*)malloc(CHUNK_BYTES);
+    if(!cur) throw std::bad_alloc();
+    end = cur + CHUNK_BYTES;
+    chunks.push_back(cur);
+  }
+
+  n = (node*)cur;
+  cur += node::size();
+  return n;
+}
+
+void node_pool::release(node* n)
+{
+  nodes.store(nodes.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+  *(node**)n = free_list;
+  free_list = n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void node_queue::push(node* n)
+{
+  int b = n->lower_bound;
+  if(b >= (int)buckets.size()) {
+    size_t old = buckets.size(), capacity = buckets.capacity();
+    buckets.resize(b + 1);
+    for(size_t i=old; i < buckets.size(); i++) {
+      buckets[i].count = 0;
+      std::fill(buckets[i].levels, buckets[i].levels + MAX_WORDS, 0);
+    }
+    bytes += (buckets.capacity() - capacity) * sizeof(bucket);
+  }
+
+  bucket& bk = buckets[b];
+  if(bk.stacks.empty()) {
+    bk.stacks.resize(node::levels());
+    bytes += bk.stacks.size() * sizeof(std::vector<node*>);
+  }
+
+  bk.stacks[n->lactive].push_back(n);
+  bits_set(bk.levels, n->lactive);
+  bk.count++;
+
+  if(count++ == 0 || b < lowest) lowest = b;
+}
+
+node* node_queue::pop()
+{
+  bucket& bk = buckets[lowest];
+  short level = bits_last(bk.levels, MAX_WORDS);
+
+  std::vector<node*>& stack = bk.stacks[level];
+  node* n = stack.back();
+  stack.pop_back();
+  if(stack.empty()) bits_clear(bk.levels, level);
+  bk.count--;
+
+  // Moves to the next bound with nodes
+  if(--count > 0) {
+    while(buckets[lowest].count == 0) lowest++;
+  }
+
+  return n;
+}
+
+void node_queue::prune(int limit, node_pool& pool)
+{
+  for(int b=std::max(limit, 0); b < (int)buckets.size(); b++) {
+    bucket& bk = buckets[b];
+    if(bk.count == 0) continue;
+
+    for(short level; (level = bits_first(bk.levels, MAX_WORDS)) != -1; ) {
+      for(node* n: bk.stacks[level]) pool.release(n);
+      bk.stacks[level].clear();
+      bits_clear(bk.levels, level);
+    }
+    count -= bk.count;
+    bk.count = 0;
+  }
+
+  if(count > 0) {
+    while(buckets[lowest].count == 0) lowest++;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
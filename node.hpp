@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: node.hpp
+//
+//  @brief Compact nodes of the branch and bound tree, the pool they are
+//  allocated from and the queue of open nodes.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NODE_HPP
+#define NODE_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Node of the solution tree. All nodes of an instance have the same size: the
+// header is followed inline by the bit set of scenes still to be added and by
+// the scenes order, one byte per scene
+class node
+{
+public:
+  int lower_bound;        // node's lower bound. It's the solution cost if lactive == ractive
+  short lactive, ractive; // end and start indices for left and right sets
+
+  // Sets the layout of nodes for an instance with nscenes scenes
+  static void setup(short nscenes);
+
+  // Size in bytes of each node
+  static inline size_t size() { return bytes; }
+
+  // Number of values lactive takes: the left set holds at most half of the
+  // scenes, rounded up
+  static inline short levels() { return (scenes + 1) / 2 + 1; }
+
+  // Scenes to be added to this node
+  inline word_t* comp() { return (word_t*)(this + 1); }
+  inline const word_t* comp() const { return (const word_t*)(this + 1); }
+
+  // Solution array
+  inline uint8_t* sol() { return (uint8_t*)(comp() + words); }
+  inline const uint8_t* sol() const { return (const uint8_t*)(comp() + words); }
+
+  // Initializes the node as the tree root
+  void root();
+
+  // Copies the contents of other
+  inline void copy(const node* other) { memcpy((void*)this, (const void*)other, bytes); }
+
+  // Copies the node into a solution
+  void to_solution(solution& out) const;
+
+  // Prefers the node with smaller bound, then the one closest to the leafs
+  inline bool operator<(const node& other) const
+  {
+    if(this->lower_bound == other.lower_bound)
+      return this->lactive < other.lactive;
+    else
+      return this->lower_bound > other.lower_bound;
+  }
+
+private:
+  static short scenes, words; // scenes of the instance and words of comp
+  static size_t bytes;        // size of the node
+
+  node();
+  node(const node&);
+};
+
+// Comparator for heaps of node pointers
+struct node_less
+{
+  inline bool operator()(const node* a, const node* b) const { return *a < *b; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Pool of nodes. Memory is taken from the system in large chunks and freed
+// nodes are kept in a free list for reuse, so the search does no allocation
+// per node
+class node_pool
+{
+public:
+  node_pool() : cur(nullptr), end(nullptr), free_list(nullptr), nodes(0) {}
+  ~node_pool();
+
+  // Gets a node (uninitialized)
+  node* alloc();
+
+  // Gets a copy of other
+  inline node* clone(const node* other) { node* n = alloc(); n->copy(other); return n; }
+
+  // Gives a node back to the pool
+  void release(node* n);
+
+  // Number of nodes in use. Nodes may be released to a pool other than the
+  // one they came from, so only the sum over all pools is meaningful
+  inline long long used() const { return nodes.load(std::memory_order_relaxed); }
+
+  // Bytes taken from the system
+  inline size_t reserved() const { return chunks.size() * CHUNK_BYTES; }
+
+private:
+  static const size_t CHUNK_BYTES = 1 << 20;
+
+  std::vector<char*> chunks; // memory taken from the system
+  char *cur, *end;           // free space of the last chunk
+  node *free_list;           // released nodes, linked through their first bytes
+  std::atomic<long long> nodes; // only changed by the owner thread, read by others
+
+  node_pool(const node_pool&);
+  node_pool& operator=(const node_pool&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Best first queue of open nodes. Bounds are small integers, so nodes are kept
+// in one bucket per bound, and each bucket in one stack per lactive, giving the
+// order of node::operator< with constant time push and pop. The lowest non
+// empty bound is tracked, and the depths of each bucket are marked in a bit
+// set. Stacks keep their memory once emptied. The bytes taken by the buckets
+// and their stacks, apart from the node pointers, are counted for the memory
+// budget, as they grow with the range of bounds rather than with the nodes
+class node_queue
+{
+public:
+  node_queue() : count(0), lowest(0), bytes(0) {}
+
+  inline bool empty() const { return count == 0; }
+  inline size_t size() const { return count; }
+
+  // Lowest bound among the nodes. The queue must not be empty
+  inline int top() const { return lowest; }
+
+  // Bytes of the buckets and their stacks. Can be read by other threads
+  inline size_t memory() const { return bytes.load(std::memory_order_relaxed); }
+
+  // Adds a node
+  void push(node* n);
+
+  // Removes and returns the node with the lowest bound, the deepest among them
+  node* pop();
+
+  // Gives every node with bound limit or above back to pool
+  void prune(int limit, node_pool& pool);
+
+  // Calls f on every node, in no particular order
+  template< typename F > void for_each(F f) const
+  {
+    for(const bucket& bk: buckets)
+      for(const std::vector<node*>& stack: bk.stacks)
+        for(node* n: stack) f(n);
+  }
+
+private:
+  struct bucket
+  {
+    size_t count;                     // nodes in the bucket
+    word_t levels[MAX_WORDS];         // lactive values with nodes
+    std::vector<std::vector<node*>> stacks; // nodes by lactive, sized on first use
+  };
+
+  std::vector<bucket> buckets; // by bound
+  size_t count;                // nodes in the queue
+  int lowest;                  // lowest bound with nodes, if any
+  std::atomic<size_t> bytes;   // memory of buckets and stacks, only changed by the owner
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* NODE_HPP */
+
+////////////////////////////////////////////////////////////////////////////////
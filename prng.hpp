@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: prng.hpp
+//
+//  @brief Fast seedable pseudo random number generator.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PRNG_HPP
+#define PRNG_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+// xoshiro256** generator. Each search context owns one, so draws need no lock
+// and runs are reproducible from the seed. Contexts seeded alike are set apart
+// with jump, which advances the sequence by 2^128 draws
+class prng
+{
+public:
+  typedef uint64_t result_type;
+
+  prng(uint64_t seed=0) { this->seed(seed); }
+
+  // Fills the state from a seed with splitmix64, as recommended by the authors
+  void seed(uint64_t seed)
+  {
+    for(short i=0; i < 4; i++) {
+      uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      s[i] = z ^ (z >> 31);
+    }
+  }
+
+  // Next 64 random bits
+  inline uint64_t operator()()
+  {
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+  }
+
+  static constexpr uint64_t min() { return 0; }
+  static constexpr uint64_t max() { return UINT64_MAX; }
+
+  // Integer in [0, n), from the high bits by multiplication instead of modulo.
+  // Products whose low half falls under 2^32 mod n are redrawn, so every value
+  // is equally likely (Lemire). The modulo is only taken on the rare low halves
+  // under n
+  inline uint32_t below(uint32_t n)
+  {
+    uint32_t r;
+    while(!accept((uint32_t)((*this)() >> 32), n, r));
+    return r;
+  }
+
+  // Fills out with count integers in [0, n), two from each 64 bit draw
+  inline void below(uint32_t n, uint32_t* out, int count)
+  {
+    for(int k=0; k < count; ) {
+      uint64_t x = (*this)();
+      if(accept((uint32_t)(x >> 32), n, out[k])) k++;
+      if(k < count && accept((uint32_t)x, n, out[k])) k++;
+    }
+  }
+
+  // Real in [0, 1) with 53 random bits
+  inline double uniform() { return ((*this)() >> 11) * (1.0 / 9007199254740992.0); }
+
+  // Number of failed trials before the first success, with success probability
+  // p, from a single draw. Replaces one draw per trial on sparse events
+  inline int geometric(double p)
+  {
+    if(p >= 1) return 0;
+    double skip = std::floor(std::log(1 - uniform()) / std::log(1 - p));
+    return skip < INT32_MAX ? (int)skip : INT32_MAX;
+  }
+
+  // Advances the sequence by 2^128 draws
+  void jump()
+  {
+    static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                     0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+    uint64_t t[4] = { 0, 0, 0, 0 };
+
+    for(short i=0; i < 4; i++) {
+      for(short b=0; b < 64; b++) {
+        if(JUMP[i] & (uint64_t(1) << b)) {
+          for(short k=0; k < 4; k++) t[k] ^= s[k];
+        }
+        (*this)();
+      }
+    }
+    for(short k=0; k < 4; k++) s[k] = t[k];
+  }
+
+private:
+  uint64_t s[4];
+
+  static inline uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+  // Maps 32 random bits x to r in [0, n), or rejects them
+  static inline bool accept(uint32_t x, uint32_t n, uint32_t& r)
+  {
+    uint64_t m = (uint64_t)x * n;
+    uint32_t l = (uint32_t)m;
+    if(l < n && l < -n % n) return false;
+    r = (uint32_t)(m >> 32);
+    return true;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* PRNG_HPP */
+
+////////////////////////////////////////////////////////////////////////////////
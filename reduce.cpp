@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: reduce.cpp
+//
+//  @brief Reductions of the instance before solving it, and the mapping of
+//  solutions back to the instance as read.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "reduce.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+static short read_scenes = 0, read_actors = 0; // sizes of the instance as read
+static std::vector<short> origin;  // scene as read of each scene kept
+static std::vector<short> dropped; // scenes as read without actors
+static short idle_actors = 0, merged_actors = 0, twin_scenes = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+void reduce_instance()
+{
+  read_scenes = nscenes;
+  read_actors = nactors;
+  origin.clear();
+  dropped.clear();
+  idle_actors = merged_actors = twin_scenes = 0;
+
+  // Actors that can wait, the first of each group working on the same scenes
+  // taking the costs of the others
+  std::vector<short> actors;
+  std::vector<int> merged;
+  for(short i=0; i < nactors; i++) {
+    if(bits_count(t[i], t.words) <= 1 || costs[i] == 0) { idle_actors++; continue; }
+
+    short k = 0;
+    while(k < (short)actors.size() && !std::equal(t[i], t[i] + t.words, t[actors[k]])) k++;
+    if(k < (short)actors.size()) {
+      merged[k] += costs[i];
+      merged_actors++;
+    } else {
+      actors.push_back(i);
+      merged.push_back(costs[i]);
+    }
+  }
+
+  // Scenes with some of those actors, and the scenes as read of the others
+  word_t kept[MAX_WORDS] = {0};
+  for(short i: actors) bits_set(kept, i);
+
+  std::vector<short> scenes;
+  for(short j=0; j < nscenes; j++) {
+    bool any = false;
+    for(short w=0; w < scene_actors.words; w++) any |= (scene_actors[j][w] & kept[w]) != 0;
+    if(any) scenes.push_back(j);
+    else dropped.push_back(j);
+  }
+
+  if(scenes.size() < 2 || actors.empty()) {
+    idle_actors = merged_actors = 0;
+    dropped.clear();
+    for(short j=0; j < nscenes; j++) origin.push_back(j);
+    return;
+  }
+
+  // Rebuilds the tables with the actors and scenes kept
+  std::vector<std::vector<bool>> works(actors.size(), std::vector<bool>(scenes.size()));
+  for(size_t i=0; i < actors.size(); i++) {
+    for(size_t j=0; j < scenes.size(); j++) works[i][j] = t.test(actors[i], scenes[j]);
+  }
+
+  nactors = actors.size();
+  nscenes = scenes.size();
+  t.resize(nactors, nscenes);
+  scene_actors.resize(nscenes, nactors);
+  costs = merged;
+  for(short i=0; i < nactors; i++) {
+    for(short j=0; j < nscenes; j++) {
+      if(works[i][j]) {
+        t.set(i, j);
+        scene_actors.set(j, i);
+      }
+    }
+  }
+  origin = scenes;
+
+  // Scenes with the same actors as an earlier one
+  for(short j=0; j < nscenes; j++) {
+    for(short k=0; k < j; k++) {
+      if(std::equal(scene_actors[j], scene_actors[j] + scene_actors.words, scene_actors[k])) {
+        twin_scenes++;
+        break;
+      }
+    }
+  }
+}
+
+std::vector<short> restore_solution(const std::vector<short>& sol)
+{
+  if(origin.empty() || sol.size() != origin.size()) return sol;
+
+  std::vector<short> restored;
+  for(short scene: sol) restored.push_back(origin[scene]);
+  restored.insert(restored.end(), dropped.begin(), dropped.end());
+
+  return restored;
+}
+
+void reduction_report()
+{
+  std::cerr << "Reduced instance: " << read_scenes << " -> " << nscenes << " scenes, ";
+  std::cerr << read_actors << " -> " << nactors << " actors (";
+  std::cerr << idle_actors << " never waiting, " << merged_actors << " merged, ";
+  std::cerr << dropped.size() << " scenes without actors, " << twin_scenes << " twin scenes)" << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: reduce.hpp
+//
+//  @brief Reductions of the instance before solving it, and the mapping of
+//  solutions back to the instance as read.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef REDUCE_HPP
+#define REDUCE_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Reduces the instance loaded on nscenes, nactors, t, scene_actors and costs,
+// keeping its optimal cost:
+// - actors working on at most one scene, or costing nothing, never add cost
+//   and are dropped
+// - actors working on the same scenes always wait alike and are merged into
+//   one with the sum of their costs
+// - scenes left without actors go to the end of the schedule, where they
+//   cost nothing, and are dropped
+// Scenes with the same actors are counted but kept, as scenes last one day.
+// Nothing is reduced if fewer than two scenes or no actor would be left
+void reduce_instance();
+
+// Schedule of the instance as read for a schedule sol of the reduced one,
+// with the dropped scenes at the end. Other vectors are returned as given
+std::vector<short> restore_solution(const std::vector<short>& sol);
+
+// Prints on stderr how much the instance shrank
+void reduction_report();
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* REDUCE_HPP */
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,765 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: search.cpp
+//
+//  @brief Best first branch and bound search over the solution tree.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "search.hpp"
+#include "bound.hpp"
+#include "instance.hpp"
+#include "metaheuristic.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Each worker owns a best first frontier and the pool its nodes come from. The
+// bounds of its frontier top and of the node it is expanding are published so
+// other threads can read the dual bound and choose steal victims without locks.
+// When the nodes in use reach the memory budget, the worker explores the
+// subtrees of its best nodes depth first, keeping their open nodes in a stack
+struct worker
+{
+  std::mutex lock;             // guards frontier and dive
+  node_queue frontier;         // open nodes (best first)
+  std::vector<node*> dive;     // open nodes of the depth first search (stack)
+  std::vector<int> dive_min;   // lowest bound among dive[0..i]
+  node_pool pool;              // nodes allocated by this worker
+
+  std::atomic<int> top;  // bound of the frontier top, INT_MAX if empty
+  std::atomic<int> hand; // bound of the node being expanded, INT_MAX if none
+  std::atomic<long long unsigned> explored; // number of explored nodes
+  std::atomic<long long unsigned> children; // number of children bounded
+  std::atomic<long long unsigned> stolen;   // number of nodes taken from other workers
+  int pruned; // best cost the frontier was last pruned against
+
+  char pad[64]; // keeps workers on different cache lines
+
+  worker() : top(INT_MAX), hand(INT_MAX), explored(0), children(0), stolen(0), pruned(INT_MAX) {}
+};
+
+static std::vector<worker*> workers;
+static std::atomic<bool> ready(false); // set while workers can be read by other threads
+static std::atomic<short> idle; // workers with no node to expand
+static std::atomic<bool> done;  // set when every worker is idle
+static size_t budget;           // bytes available for nodes, 0 if unlimited
+static short greedy_every;      // depths whose nodes get a greedy completion, 0 for popped nodes
+static long long unsigned node_limit; // nodes explored before stopping, 0 if unlimited
+static std::chrono::steady_clock::time_point started; // start of the search
+static const long long unsigned SEED_EVERY = 1024; // nodes explored by a worker between seeds of the genetic algorithm
+static const short STEAL_SLICE = 16; // nodes a thief takes at once from a dive stack
+static bitmatrix twins_below, twins_above; // scenes with the same actors and a lower (higher) index
+
+// Checkpoints are written by the first worker while the others wait without
+// a node in hand, so the frontiers and dive stacks hold every open node
+static const char* checkpoint_file = nullptr; // where the search is saved, if set
+static double checkpoint_every;               // seconds between checkpoints
+static std::chrono::steady_clock::time_point next_checkpoint; // only read by the first worker
+static std::atomic<bool> saving(false);       // set while a checkpoint is written
+static std::atomic<short> paused, active;     // workers waiting for it, and still running
+static FILE* resume_file = nullptr;           // checkpoint whose open nodes the next explore takes
+static std::string resume_name;
+static long long unsigned resume_explored, resume_nodes;
+
+////////////////////////////////////////////////////////////////////////////////
+// Checkpoint files start with this header, followed by the best solution as
+// 16 bits scenes, in order, and by the open nodes as they are kept in memory
+static const char CHECKPOINT_MAGIC[4] = { 'S', 'O', 'P', 'C' };
+static const uint16_t CHECKPOINT_VERSION = 1;
+
+struct checkpoint_header
+{
+  char magic[4];
+  uint16_t version, nscenes, nactors, reserved;
+  uint32_t node_bytes;  // size of each node
+  int32_t best_cost;    // INT_MAX without a solution
+  uint32_t padding;     // aligns fingerprint, written as 0
+  uint64_t fingerprint; // of the instance solved
+  uint64_t explored;    // nodes explored so far
+  uint64_t nodes;       // open nodes that follow
+};
+
+// A layout change needs a new CHECKPOINT_VERSION
+static_assert(sizeof(checkpoint_header) == 48, "checkpoint header layout changed");
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether the nodes in use, with their share of the frontiers, and the buckets
+// of the frontiers reached the budget
+static bool over_budget()
+{
+  if(budget == 0) return false;
+
+  long long used = 0, queues = 0;
+  for(worker* w: workers) {
+    used += w->pool.used();
+    queues += w->frontier.memory();
+  }
+
+  return used * (long long)(node::size() + 2 * sizeof(node*)) + queues >= (long long)budget;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Publishes the lowest bound of the frontier and the dive stack. Called with the
+// frontier locked
+static inline void publish(worker* w)
+{
+  int top = w->frontier.empty() ? INT_MAX : w->frontier.top();
+  if(!w->dive.empty()) top = std::min(top, w->dive_min.back());
+
+  w->top.store(top);
+}
+
+// Pushes n on the dive stack of w. Called with the frontier locked
+static inline void push_dive(worker* w, node* n)
+{
+  w->dive_min.push_back(w->dive.empty() ? n->lower_bound : std::min(w->dive_min.back(), n->lower_bound));
+  w->dive.push_back(n);
+}
+
+// Takes a node from w and makes it the node in hand of self. Called with the
+// frontier of w locked. The owner keeps diving while it has a dive stack,
+// thieves prefer the frontier top and otherwise take the STEAL_SLICE
+// shallowest nodes of the stack: the first one in hand, the others on extra,
+// their number on nextra, for the thief's own stack. The taken nodes are
+// published in hand before they leave w, so they are never missing from the
+// dual bound
+static inline node* pop(worker* w, worker* self, node** extra=nullptr, short* nextra=nullptr)
+{
+  node* n;
+
+  if(!w->dive.empty() && (w == self || w->frontier.empty())) {
+    if(w == self) {
+      n = w->dive.back();
+      self->hand.store(n->lower_bound);
+      w->dive.pop_back();
+      w->dive_min.pop_back();
+    } else {
+      short slice = std::min<size_t>(STEAL_SLICE, w->dive.size());
+      n = w->dive.front();
+      self->hand.store(w->dive_min[slice - 1]);
+      std::copy(w->dive.begin() + 1, w->dive.begin() + slice, extra);
+      *nextra = slice - 1;
+
+      // The rest moves down in place, its lowest bounds are found again
+      w->dive.erase(w->dive.begin(), w->dive.begin() + slice);
+      w->dive_min.resize(w->dive.size());
+      for(size_t i=0; i < w->dive.size(); i++) {
+        w->dive_min[i] = i ? std::min(w->dive_min[i - 1], w->dive[i]->lower_bound) : w->dive[i]->lower_bound;
+      }
+    }
+  } else {
+    self->hand.store(w->frontier.top());
+    n = w->frontier.pop();
+  }
+
+  publish(w);
+
+  return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Finds the scenes with the same actors as each scene
+static void twins_setup()
+{
+  twins_below.resize(nscenes, nscenes);
+  twins_above.resize(nscenes, nscenes);
+
+  for(short j=0; j < nscenes; j++) {
+    for(short k=0; k < j; k++) {
+      if(std::equal(scene_actors[j], scene_actors[j] + scene_actors.words, scene_actors[k])) {
+        twins_below.set(j, k);
+        twins_above.set(k, j);
+      }
+    }
+  }
+}
+
+// Sets on expand the scenes of comp worth placing at the next position of the
+// left (right) set of the node summarized by state. Children placing the
+// scene s' are dominated, and left out, in two cases:
+// - scenes with the same actors cost the same anywhere, so they are placed
+//   in the order of their indices: the lowest on the left, the highest on the
+//   right
+// - with o the actors on location at the position, that is, working on the
+//   set being extended and after it (before it), moving a scene s with
+//   o <= A(s) <= o + A(s') from the middle to the position never adds cost,
+//   as the actors of s span the days in between and the other actors only
+//   shift away from the set. s' is left out when such an s is placed
+//   instead. A scene with exactly the actors on location is placed at once.
+//   The relation has no cycles among scenes with different actors, so one
+//   child always remains
+// The second rule moves s to the end of the schedule at the first position of
+// the right set, so it is only used there if s is above min, the scene the
+// symmetry of solutions requires, and not at all at the root
+static void dominance(const bound_state& state, const word_t* comp, bool left, short min, bool root, word_t* expand)
+{
+  const short words = scene_actors.words, swords = nwords(nscenes);
+  const bitmatrix& twins = left ? twins_below : twins_above;
+
+  // Scenes placed first among their twins
+  std::fill(expand, expand + MAX_WORDS, 0);
+  for(short w=0; w < swords; w++) {
+    for(word_t b = comp[w]; b; b &= b - 1) {
+      short scene = w * WORD_BITS + __builtin_ctzll(b);
+
+      bool first = true;
+      for(short v=0; v < swords; v++) first &= (twins[scene][v] & comp[v]) == 0;
+      if(first) bits_set(expand, scene);
+    }
+  }
+  if(root) return;
+
+  // Actors on location: in the set being extended and in the rest
+  word_t rest[MAX_WORDS] = {0}, on[MAX_WORDS] = {0};
+  for(short w=0; w < swords; w++) {
+    for(word_t b = comp[w]; b; b &= b - 1) {
+      const word_t* actors = scene_actors[w * WORD_BITS + __builtin_ctzll(b)];
+      for(short v=0; v < words; v++) rest[v] |= actors[v];
+    }
+  }
+  for(short i=0; i < nactors; i++) {
+    bool here = left ? state.lmost[i] != -1 : state.rmost[i] != -1;
+    bool there = left ? state.rmost[i] != -1 : state.lmost[i] != -1;
+    if(here && (there || bits_test(rest, i))) bits_set(on, i);
+  }
+
+  // Scenes that can take the place of others
+  short dominant[MAX_BITS], ndominant = 0;
+  for(short w=0; w < swords; w++) {
+    for(word_t b = expand[w]; b; b &= b - 1) {
+      short scene = w * WORD_BITS + __builtin_ctzll(b);
+      if(scene <= min) continue;
+
+      bool covers = true;
+      for(short v=0; v < words; v++) covers &= (on[v] & ~scene_actors[scene][v]) == 0;
+      if(covers) dominant[ndominant++] = scene;
+    }
+  }
+
+  for(short d=0; d < ndominant; d++) {
+    const word_t* actors = scene_actors[dominant[d]];
+
+    for(short w=0; w < swords; w++) {
+      for(word_t b = expand[w]; b; b &= b - 1) {
+        short scene = w * WORD_BITS + __builtin_ctzll(b);
+        if(scene == dominant[d]) continue;
+
+        bool dominated = true;
+        for(short v=0; v < words; v++) dominated &= (actors[v] & ~on[v] & ~scene_actors[scene][v]) == 0;
+        if(dominated) bits_clear(expand, scene);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes the open nodes of every worker, the best solution and the number of
+// explored nodes to the checkpoint file. Workers must be paused or done. The
+// file is written aside and renamed over the last checkpoint, so a run killed
+// while writing keeps it. Failures are reported and the search goes on
+static void save_checkpoint()
+{
+  std::string temp = std::string(checkpoint_file) + ".tmp";
+  FILE* out = fopen(temp.c_str(), "wb");
+  if(!out) {
+    std::cerr << "Can't write checkpoint " << temp << std::endl;
+    return;
+  }
+
+  checkpoint_header header = checkpoint_header();
+  memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+  header.version = CHECKPOINT_VERSION;
+  header.nscenes = nscenes;
+  header.nactors = nactors;
+  header.node_bytes = node::size();
+  header.fingerprint = instance_fingerprint();
+  header.explored = search_explored_nodes();
+  header.nodes = 0;
+  for(worker* w: workers) header.nodes += w->frontier.size() + w->dive.size();
+
+  std::vector<uint16_t> best(nscenes);
+  {
+    std::lock_guard<std::mutex> guard(sol_lock);
+    header.best_cost = best_cost;
+    for(short j=0; j < nscenes; j++) best[j] = header.best_cost < INT_MAX ? best_sol.sol[j] : j;
+  }
+
+  fwrite(&header, sizeof(header), 1, out);
+  fwrite(best.data(), sizeof(uint16_t), nscenes, out);
+  for(worker* w: workers) {
+    w->frontier.for_each([out](const node* n) { fwrite(n, node::size(), 1, out); });
+    for(node* n: w->dive) fwrite(n, node::size(), 1, out);
+  }
+
+  if((ferror(out) | fclose(out)) || rename(temp.c_str(), checkpoint_file) != 0) {
+    std::cerr << "Can't write checkpoint " << checkpoint_file << std::endl;
+    remove(temp.c_str());
+  }
+}
+
+// Saves a checkpoint if it is due, once the other workers are paused. Called
+// by the first worker with no node in hand
+static void checkpoint_if_due()
+{
+  if(!checkpoint_file || std::chrono::steady_clock::now() < next_checkpoint) return;
+
+  saving = true;
+  while(paused.load() < active.load() - 1) std::this_thread::yield();
+
+  save_checkpoint();
+  next_checkpoint = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(checkpoint_every));
+
+  // Every worker resumes before another checkpoint can start
+  saving = false;
+  while(paused.load() > 0) std::this_thread::yield();
+}
+
+// Waits while a checkpoint is written. Called by the other workers with no
+// node in hand
+static inline void wait_checkpoint()
+{
+  if(!saving.load()) return;
+
+  paused++;
+  while(saving.load()) std::this_thread::yield();
+  paused--;
+}
+
+// Checkpoint duties of self before taking a node
+static inline void checkpoint(worker* self)
+{
+  if(self == workers[0]) checkpoint_if_due();
+  else wait_checkpoint();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Gets the next node to be expanded by self: its own best node or, if its
+// frontier is empty, the best node of another worker. Returns nullptr when
+// every frontier is empty and no worker is expanding a node, once the node
+// limit is reached, or when a stop is requested
+static node* take(worker* self)
+{
+  checkpoint(self);
+
+  // Every worker stops once the node limit is reached or when asked to
+  if(node_limit && search_explored_nodes() >= node_limit) done = true;
+  if(stop_requested.load(std::memory_order_relaxed)) done = true;
+  if(done) return nullptr;
+
+  {
+    std::lock_guard<std::mutex> guard(self->lock);
+    if(!self->frontier.empty() || !self->dive.empty()) return pop(self, self);
+  }
+
+  // The last worker to become idle finishes the search
+  if(++idle == (short)workers.size()) done = true;
+
+  while(!done) {
+    checkpoint(self);
+
+    // Looks for the worker with the best frontier top
+    worker* victim = nullptr;
+    int best = INT_MAX;
+    for(worker* w: workers) {
+      int top = w->top.load();
+      if(w != self && top < best) { best = top; victim = w; }
+    }
+
+    if(victim) {
+      // Stops being idle before stealing, so no node can exist while all are idle
+      idle--;
+      node* n = nullptr;
+      node* extra[STEAL_SLICE];
+      short nextra = 0;
+      {
+        std::lock_guard<std::mutex> guard(victim->lock);
+        if(!victim->frontier.empty() || !victim->dive.empty()) n = pop(victim, self, extra, &nextra);
+      }
+
+      // Nodes of a slice go to the thief's stack. Locks are taken one at a
+      // time, so thieves never wait on each other
+      if(n) {
+        self->stolen.store(self->stolen.load(std::memory_order_relaxed) + 1 + nextra, std::memory_order_relaxed);
+        if(nextra) {
+          std::lock_guard<std::mutex> guard(self->lock);
+          for(short k=0; k < nextra; k++) push_dive(self, extra[k]);
+          publish(self);
+        }
+        return n;
+      }
+      if(++idle == (short)workers.size()) done = true;
+    }
+
+    std::this_thread::yield();
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drops at once the nodes of the frontier of self that can't beat the best
+// solution, whenever it improves. Nodes on the dive stack are dropped as they
+// are popped
+static void prune(worker* self)
+{
+  int cost = best_cost;
+  if(cost >= self->pruned) return;
+  self->pruned = cost;
+
+  std::lock_guard<std::mutex> guard(self->lock);
+  self->frontier.prune(cost, self->pool);
+  publish(self);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main loop of a worker
+static void run(worker* self)
+{
+  bound_state state; // summary of the node being expanded
+  solution parent(nscenes), greedy(nscenes); // scratch solutions for the greedy completions
+  std::vector<node*> children; // children that survived bounding
+  children.reserve(nscenes);
+  int ck1k2[MAX_BITS]; // k1 + k2 of each child, by scene
+  word_t sbl[MAX_WORDS], sbr[MAX_WORDS]; // bl/br membership of the actors of a child
+  const short words = nwords(nscenes); // comp words stored on each node
+
+  node* front;
+  while((front = take(self)) != nullptr)
+  {
+    // Drops the open nodes a new best solution rules out
+    prune(self);
+
+    // The node can't lead to a better solution
+    if(front->lower_bound >= best_cost) {
+      self->hand.store(INT_MAX);
+      self->pool.release(front);
+      continue;
+    }
+
+    // If we've found a possible solution
+    if(front->lactive == front->ractive)
+    {
+      front->to_solution(greedy);
+      update_solution(greedy);
+    } else
+    {
+      // Increase number of explored nodes
+      long long unsigned explored = self->explored.load(std::memory_order_relaxed) + 1;
+      self->explored.store(explored, std::memory_order_relaxed);
+
+      // Nodes are popped best first, so some of them seed the genetic
+      // algorithm running alongside with their greedy completions
+      if(explored % SEED_EVERY == 0 && ga_running()) {
+        front->to_solution(greedy);
+        greedy_solution(greedy);
+        update_solution(greedy);
+        ga_seed(greedy);
+      }
+
+      int idx = -1, min = -1;
+      bool left = true, root = front->lactive == 0 && front->ractive == nscenes;
+
+      // Children bounds are derived from the summary of their parent
+      state.build(front);
+
+      // Completes the node by using a greedy algorithm, if its children won't
+      if(greedy_every == 0 && state.completion(front->comp(), front->lactive, -1, -1, true) < best_cost) {
+        front->to_solution(greedy);
+        greedy_solution(greedy);
+        update_solution(greedy);
+      }
+
+      if(front->lactive == nscenes - front->ractive) {
+        idx = ++front->lactive-1; // insert on the left
+      } else {
+        idx = --front->ractive; // insert on the right
+        left = false;
+        min = (front->ractive == nscenes-1) ? front->sol()[front->lactive-1] : -1;
+      }
+
+      // Scenes that are not dominated by others at this position
+      word_t expand[MAX_WORDS];
+      dominance(state, front->comp(), left, min, root, expand);
+
+      // k1 + k2 of all the children at once, and the parent as a solution
+      // the greedy completions of the children start from
+      state.children(expand, idx, left, ck1k2, sbl, sbr);
+      front->to_solution(parent);
+
+      // Whether children at this depth get a greedy completion
+      short depth = front->lactive + nscenes - front->ractive;
+      bool complete = greedy_every > 0 && depth % greedy_every == 0;
+
+      // for each possible scene, bounds the child with it and keeps it if its
+      // lower bound allows. Nodes are only created for the children kept. A
+      // child bounded at or above the best solution is dropped before its
+      // greedy completion, which could not be better
+      long long unsigned bounded = 0;
+      for(short scene=0; scene < nscenes; scene++) {
+        if(!bits_test(expand, scene)) continue;
+
+        if(min < scene) { // This if breaks simetry of solutions
+          bounded++;
+
+          int bound = ck1k2[scene];
+          if(bound >= best_cost) continue;
+
+          word_t comp[MAX_WORDS], bl[MAX_WORDS], br[MAX_WORDS];
+          std::copy(front->comp(), front->comp() + words, comp);
+          std::fill(comp + words, comp + MAX_WORDS, 0);
+          bits_clear(comp, scene);
+          state.child_sets(scene, sbl, sbr, bl, br);
+          bound = lower_bound(comp, bl, br, bound);
+          if(bound >= best_cost) continue;
+
+          // Completes the partial solution candidate by using a greedy
+          // algorithm. Its cost is found from the summary, the solution is
+          // only built if it is better than the best solution so far
+          int upper = INT_MAX;
+          if(complete) {
+            upper = state.completion(comp, front->lactive, scene, idx, left);
+            if(upper < best_cost) {
+              greedy = parent;
+              greedy.sol[idx] = scene;
+              greedy.comp.erase(std::find(greedy.comp.begin(), greedy.comp.end(), scene));
+              greedy_solution(greedy);
+              update_solution(greedy);
+            }
+          }
+
+          // mature node condition
+          if(bound < upper && bound < best_cost) {
+            node* new_node = self->pool.clone(front);
+            bits_clear(new_node->comp(), scene);
+            new_node->sol()[idx] = scene;
+            new_node->lower_bound = bound;
+            children.push_back(new_node);
+          }
+        }
+      }
+      self->children.store(self->children.load(std::memory_order_relaxed) + bounded, std::memory_order_relaxed);
+
+      // Adds the children to the frontier before releasing the parent. Once
+      // the budget is reached, they go to the dive stack with the best on top
+      {
+        std::lock_guard<std::mutex> guard(self->lock);
+        if(!self->dive.empty() || over_budget()) {
+          std::sort(children.begin(), children.end(), node_less());
+          for(node* child: children) push_dive(self, child);
+        } else {
+          for(node* child: children) self->frontier.push(child);
+        }
+        publish(self);
+      }
+      children.clear();
+    }
+
+    self->hand.store(INT_MAX);
+    self->pool.release(front);
+  }
+
+  active--;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether a node read from a checkpoint is one the search could have made: a
+// non negative bound, sides of the sizes the search alternates between, placed
+// scenes that are distinct, and comp holding exactly the scenes not placed
+static bool valid_node(const node* n)
+{
+  if(n->lower_bound < 0 || n->lactive < 0 || n->lactive > n->ractive || n->ractive > nscenes) return false;
+  short right = nscenes - n->ractive;
+  if(right != n->lactive && right != n->lactive - 1) return false;
+
+  word_t seen[MAX_WORDS];
+  short words = nwords(nscenes);
+  std::copy(n->comp(), n->comp() + words, seen);
+  if(bits_last(seen, words) >= nscenes) return false;
+
+  const uint8_t* sol = n->sol();
+  for(short i=0; i < nscenes; i++) {
+    if(i == n->lactive) i = n->ractive;
+    if(i == nscenes) break;
+    if(sol[i] >= nscenes || bits_test(seen, sol[i])) return false;
+    bits_set(seen, sol[i]);
+  }
+
+  return bits_count(seen, words) == nscenes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void explore(short nthreads, size_t memory_mb, short greedy_depth, long long unsigned max_nodes)
+{
+  budget = (memory_mb << 20) / 10 * 9; // leaves room for everything else
+  greedy_every = greedy_depth;
+  node_limit = max_nodes;
+
+  ready = false;
+  for(worker* w: workers) delete w;
+  workers.clear();
+  for(short i=0; i < nthreads; i++) workers.push_back(new worker());
+
+  idle = 0;
+  done = false;
+  paused = 0;
+  active = nthreads;
+  started = std::chrono::steady_clock::now();
+  next_checkpoint = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(checkpoint_every));
+
+  node::setup(nscenes);
+  bound_setup();
+  twins_setup();
+
+  if(resume_file) {
+    // Open nodes of the checkpoint are dealt among the workers, those the
+    // best solution rules out are dropped
+    for(long long unsigned k=0; k < resume_nodes; k++) {
+      worker* w = workers[k % nthreads];
+      node* n = w->pool.alloc();
+      if(fread(n, node::size(), 1, resume_file) != 1) {
+        std::cerr << "Checkpoint " << resume_name << " is truncated" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      if(!valid_node(n)) {
+        std::cerr << "Checkpoint " << resume_name << " has an invalid node" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+
+      if(n->lower_bound >= best_cost) w->pool.release(n);
+      else w->frontier.push(n);
+    }
+    fclose(resume_file);
+    resume_file = nullptr;
+    workers[0]->explored = resume_explored;
+  } else {
+    // Creates tree root with empty solution
+    node* root = workers[0]->pool.alloc();
+    root->root();
+    workers[0]->frontier.push(root);
+  }
+  for(worker* w: workers) publish(w);
+  ready = true;
+
+  // The calling thread is the first worker
+  std::vector<std::thread> threads;
+  for(short i=1; i < nthreads; i++) threads.push_back(std::thread(run, workers[i]));
+  run(workers[0]);
+  for(auto& thread: threads) thread.join();
+
+  // The open nodes left, if any, are those to resume from
+  if(checkpoint_file) save_checkpoint();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void search_checkpoint(const char* filename, double interval)
+{
+  checkpoint_file = filename;
+  checkpoint_every = interval;
+}
+
+void search_resume(const char* filename)
+{
+  FILE* in = fopen(filename, "rb");
+  checkpoint_header header;
+  if(!in || fread(&header, sizeof(header), 1, in) != 1 ||
+     memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0 || header.version != CHECKPOINT_VERSION) {
+    std::cerr << "File " << filename << " is not a checkpoint" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // The node size only means something once the instance is known to match
+  if(header.nscenes != nscenes || header.nactors != nactors) {
+    std::cerr << "Checkpoint " << filename << " is of another instance" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  node::setup(nscenes);
+  if(header.node_bytes != node::size()) {
+    std::cerr << "Checkpoint " << filename << " was written by another build" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if(header.fingerprint != instance_fingerprint()) {
+    std::cerr << "Checkpoint " << filename << " is of another instance" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // The best solution is checked and its cost found again
+  std::vector<uint16_t> best(nscenes);
+  if(fread(best.data(), sizeof(uint16_t), nscenes, in) != (size_t)nscenes) {
+    std::cerr << "Checkpoint " << filename << " is truncated" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if(header.best_cost < INT_MAX) {
+    solution sol(nscenes);
+    std::vector<bool> seen(nscenes, false);
+    for(short j=0; j < nscenes; j++) {
+      if(best[j] >= nscenes || seen[best[j]]) {
+        std::cerr << "Checkpoint " << filename << " has an invalid solution" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      seen[best[j]] = true;
+      sol.sol[j] = best[j];
+    }
+    sol.comp.clear();
+    sol.lactive = nscenes;
+    sol.lower_bound = get_cost(sol);
+    update_solution(sol);
+  }
+
+  resume_file = in;
+  resume_name = filename;
+  resume_explored = header.explored;
+  resume_nodes = header.nodes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int search_dual_bound()
+{
+  int dual = INT_MAX;
+  if(!ready) return dual;
+
+  // A node stolen during the first pass is seen by its new owner in the second
+  for(short pass=0; pass < 2; pass++) {
+    for(worker* w: workers) dual = std::min(dual, std::min(w->top.load(), w->hand.load()));
+  }
+
+  return dual;
+}
+
+long long unsigned search_explored_nodes()
+{
+  long long unsigned total = 0;
+  if(!ready) return total;
+
+  for(worker* w: workers) total += w->explored.load();
+
+  return total;
+}
+
+long long search_open_nodes()
+{
+  long long total = 0;
+  if(!ready) return total;
+
+  // Includes the nodes being expanded
+  for(worker* w: workers) total += w->pool.used();
+
+  return total;
+}
+
+void search_report()
+{
+  long long unsigned total = 0, stolen = 0;
+  for(worker* w: workers) {
+    total += w->children.load();
+    stolen += w->stolen.load();
+  }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+  std::cerr << "Children bounded: " << total << " in " << elapsed.count() << " s (";
+  std::cerr << (long long unsigned)(total / std::max(elapsed.count(), 1e-9)) << "/s)" << std::endl;
+  if(workers.size() > 1) std::cerr << "Nodes stolen: " << stolen << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: search.hpp
+//
+//  @brief Best first branch and bound search over the solution tree.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "node.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Explores the solution tree by using branch and bound - best first, with
+// nthreads workers. Each worker keeps its own frontier and steals the best node
+// of the others when its own runs out. When the nodes take memory_mb megabytes,
+// the workers switch to depth first search below their best nodes until memory
+// is available again (0 for no limit). Children at depths multiple of
+// greedy_depth are completed greedily for upper bounds, or only the nodes being
+// expanded if it is 0. Stops after max_nodes explored nodes, unless it is 0,
+// or once stop_requested is set. Updates best_sol along the way
+void explore(short nthreads=1, size_t memory_mb=0, short greedy_depth=1, long long unsigned max_nodes=0);
+
+// Makes explore save its open nodes, best_sol and the number of explored nodes
+// to filename every interval seconds, and when it returns
+void search_checkpoint(const char* filename, double interval);
+
+// Continues from the checkpoint on filename: best_sol is restored at once and
+// the next explore starts from its open nodes instead of the root. Exits with
+// a message if the file is not a checkpoint of the instance loaded
+void search_resume(const char* filename);
+
+// Lowest bound among the open nodes of all workers
+int search_dual_bound();
+
+// Number of nodes explored by all workers
+long long unsigned search_explored_nodes();
+
+// Number of open nodes of all workers
+long long search_open_nodes();
+
+// Prints on stderr the children bounded by all workers and how many per second,
+// and the nodes stolen among them when there are several
+void search_report();
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* SEARCH_HPP */
+
+////////////////////////////////////////////////////////////////////////////////
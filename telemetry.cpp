@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: telemetry.cpp
+//
+//  @brief Live progress of the solvers as JSON lines, kept apart from the
+//  result printed on stdout.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "telemetry.hpp"
+#include "metaheuristic.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+static FILE* out = nullptr;            // telemetry stream, nullptr if closed
+static std::atomic<bool> active(false); // whether records are being written
+static std::chrono::steady_clock::time_point started; // start of the telemetry
+static std::chrono::duration<double> interval;        // time between records
+
+static std::mutex lock;                 // guards pending
+static std::condition_variable wake;    // signals the writer
+static std::vector<std::pair<const char*, int>> pending; // events waiting for their records, with the incumbent they saw
+
+static std::mutex write_lock; // guards the stream and the previous counters
+static double last_time = 0;  // time of the previous record
+static long long unsigned last_explored = 0, last_generations = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+// Appends "name":value to the record, or null if the value is unknown
+static inline void field(std::string& rec, const char* name, bool known, long long value)
+{
+  char buf[64];
+  if(known) snprintf(buf, sizeof(buf), ",\"%s\":%lld", name, value);
+  else snprintf(buf, sizeof(buf), ",\"%s\":null", name);
+  rec += buf;
+}
+
+static inline void field(std::string& rec, const char* name, double value)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), ",\"%s\":%.1f", name, value);
+  rec += buf;
+}
+
+// Writes one record, of the incumbent seen by the event. The counters are
+// read without locks
+static void record(const char* event, int incumbent)
+{
+  std::lock_guard<std::mutex> guard(write_lock);
+  if(!out) return;
+
+  double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+  double delta = std::max(now - last_time, 1e-9);
+
+  int dual = dual_bound ? dual_bound() : INT_MAX;
+  long long open = open_nodes ? open_nodes() : -1;
+  long long unsigned explored = explored_nodes ? explored_nodes() : 0;
+  long long unsigned generations = ga_generations();
+
+  char head[64];
+  snprintf(head, sizeof(head), "{\"t\":%.3f,\"event\":\"%s\"", now, event);
+  std::string rec(head);
+  field(rec, "incumbent", incumbent != INT_MAX, incumbent);
+  field(rec, "dual", dual != INT_MAX, std::min(dual, incumbent));
+  field(rec, "open", open >= 0, open);
+  field(rec, "explored", explored_nodes != nullptr, explored);
+  field(rec, "nodes_per_s", (explored - std::min(explored, last_explored)) / delta);
+  field(rec, "generations", true, generations);
+  field(rec, "generations_per_s", (generations - std::min(generations, last_generations)) / delta);
+  rec += "}\n";
+
+  fputs(rec.c_str(), out);
+  fflush(out);
+
+  last_time = now;
+  last_explored = explored;
+  last_generations = generations;
+}
+
+// Writes the pending events as they come, and a tick record every interval
+static void write_records()
+{
+  std::vector<std::pair<const char*, int>> events;
+  std::unique_lock<std::mutex> guard(lock);
+
+  for(;;) {
+    if(pending.empty() && wake.wait_for(guard, interval) == std::cv_status::timeout) {
+      guard.unlock();
+      record("tick", best_cost);
+      guard.lock();
+      continue;
+    }
+
+    events.swap(pending);
+    guard.unlock();
+    for(auto& event: events) record(event.first, event.second);
+    events.clear();
+    guard.lock();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool telemetry_open(const char* target, float seconds)
+{
+  if(strcmp(target, "-") == 0) out = stderr;
+  else if(strncmp(target, "fd:", 3) == 0) out = fdopen(atoi(target + 3), "w");
+  else out = fopen(target, "w");
+
+  if(!out) return false;
+
+  started = std::chrono::steady_clock::now();
+  interval = std::chrono::duration<double>(std::max(seconds, 0.001f));
+  pending.reserve(64);
+
+  active = true;
+  record("start", best_cost);
+  std::thread(write_records).detach();
+
+  return true;
+}
+
+void telemetry_event(const char* event)
+{
+  if(!active.load(std::memory_order_relaxed)) return;
+
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    pending.push_back(std::make_pair(event, best_cost.load()));
+  }
+  wake.notify_one();
+}
+
+void telemetry_close()
+{
+  if(!active.exchange(false)) return;
+
+  // The writer is not waited for, it finds the stream gone and writes nothing
+  // else
+  record("end", best_cost);
+
+  std::lock_guard<std::mutex> guard(write_lock);
+  out = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
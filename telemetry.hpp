@@ -0,0 +1,39 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  @file: telemetry.hpp
+//
+//  @brief Live progress of the solvers as JSON lines, kept apart from the
+//  result printed on stdout.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Starts writing records to target: a file path, "-" for stderr or "fd:N" for
+// an open descriptor. A record is written every interval seconds and on every
+// event, by a thread of its own, so the solvers only signal it. Each record is
+// a JSON object on its own line with the elapsed seconds, the event, the
+// incumbent cost, the dual bound, the open nodes, the explored nodes and the
+// genetic algorithm generations, with their rates since the previous record.
+// Values the running solver does not have are null. Returns false if target
+// can't be opened
+bool telemetry_open(const char* target, float interval);
+
+// Asks for a record of event ("incumbent", "ga_done", ...). Does nothing if
+// the telemetry is not open
+void telemetry_event(const char* event);
+
+// Writes the "end" record and stops the telemetry
+void telemetry_close();
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* TELEMETRY_HPP */
+
+////////////////////////////////////////////////////////////////////////////////